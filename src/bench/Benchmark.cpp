@@ -0,0 +1,107 @@
+#include "Benchmark.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <sstream>
+
+void BenchmarkSuite::Add(std::string const& name, std::string const& unit, Body body,
+                         double min_seconds) {
+  entries_.push_back({name, unit, body, min_seconds});
+}
+
+std::vector<BenchmarkResult> BenchmarkSuite::Run(Options const& options,
+                                                 std::ostream& progress) const {
+  typedef std::chrono::steady_clock Clock;
+  std::vector<BenchmarkResult> results;
+
+  for (auto const& entry : entries_) {
+    if (entry.name.find(options.filter) == std::string::npos) {
+      continue;
+    }
+
+    double min_seconds = entry.min_seconds < 0 ? options.min_seconds : entry.min_seconds;
+    BenchmarkResult best = {entry.name, entry.unit, 0, 0.0, 0.0};
+    for (unsigned int r = 0; r < options.repetitions; ++r) {
+      unsigned long operations = 0;
+      double seconds = 0.0;
+      Clock::time_point start = Clock::now();
+      do {
+        operations += entry.body();
+        seconds = std::chrono::duration<double>(Clock::now() - start).count();
+      } while (seconds < min_seconds);
+
+      double rate = operations / seconds;
+      if (rate > best.rate) {
+        best.operations = operations;
+        best.seconds = seconds;
+        best.rate = rate;
+      }
+    }
+
+    progress << std::left << std::setw(32) << best.name << std::right << std::setw(14)
+             << std::fixed << std::setprecision(1) << best.rate << " " << best.unit << "/s"
+             << std::endl;
+    results.push_back(best);
+  }
+  return results;
+}
+
+void BenchmarkSuite::WriteJson(std::vector<BenchmarkResult> const& results,
+                               std::ostream& output) {
+  output << "{\n  \"benchmarks\": [";
+  for (unsigned int i = 0; i < results.size(); ++i) {
+    BenchmarkResult const& result = results[i];
+    output << (i == 0 ? "\n" : ",\n") << "    {\"name\": \"" << result.name << "\", \"unit\": \""
+           << result.unit << "\", \"operations\": " << result.operations
+           << ", \"seconds\": " << std::setprecision(9) << result.seconds
+           << ", \"rate\": " << result.rate << "}";
+  }
+  output << "\n  ]\n}\n";
+}
+
+std::map<std::string, double> BenchmarkSuite::ReadJson(std::istream& input) {
+  static std::string const kName = "\"name\": \"";
+  static std::string const kRate = "\"rate\": ";
+
+  /* Only needs to understand WriteJson's own output: one benchmark object per line. */
+  std::map<std::string, double> rates;
+  std::string line;
+  while (std::getline(input, line)) {
+    size_t name = line.find(kName);
+    size_t rate = line.find(kRate);
+    if (name == std::string::npos || rate == std::string::npos) {
+      continue;
+    }
+    name += kName.size();
+    std::string key = line.substr(name, line.find('"', name) - name);
+    rates[key] = std::strtod(line.c_str() + rate + kRate.size(), nullptr);
+  }
+  return rates;
+}
+
+bool BenchmarkSuite::Compare(std::vector<BenchmarkResult> const& results,
+                             std::map<std::string, double> const& baseline, double threshold,
+                             std::ostream& output) {
+  bool passed = true;
+  output << std::left << std::setw(32) << "benchmark" << std::right << std::setw(14) << "baseline"
+         << std::setw(14) << "current" << std::setw(10) << "change" << std::endl;
+
+  for (auto const& result : results) {
+    auto it = baseline.find(result.name);
+    if (it == baseline.end() || it->second <= 0) {
+      output << std::left << std::setw(32) << result.name << std::right << std::setw(14) << "-"
+             << std::setw(14) << std::fixed << std::setprecision(1) << result.rate << std::endl;
+      continue;
+    }
+
+    double change = result.rate / it->second - 1.0;
+    bool regressed = change < -threshold;
+    passed = passed && !regressed;
+    output << std::left << std::setw(32) << result.name << std::right << std::setw(14)
+           << std::fixed << std::setprecision(1) << it->second << std::setw(14) << result.rate
+           << std::setw(9) << std::showpos << change * 100 << std::noshowpos << "%"
+           << (regressed ? "  REGRESSION" : "") << std::endl;
+  }
+  return passed;
+}
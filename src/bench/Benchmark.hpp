@@ -0,0 +1,66 @@
+#ifndef BENCHMARK_HPP
+#define BENCHMARK_HPP
+
+#include <functional>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+struct BenchmarkResult {
+  std::string name;
+  std::string unit;
+  unsigned long operations;
+  double seconds;
+  double rate; /* operations per second, best repetition */
+};
+
+/* Runs named bodies repeatedly for a minimum wall time and keeps the fastest repetition, which is
+ * the least disturbed by the rest of the machine. */
+class BenchmarkSuite {
+ public:
+  /* Runs one batch of work and returns how many operations it did. */
+  typedef std::function<unsigned long()> Body;
+
+  struct Options {
+    std::string filter;
+    unsigned int repetitions = 5;
+    double min_seconds = 0.2;
+  };
+
+  /* min_seconds = 0 runs a single batch per repetition, for bodies that take seconds. */
+  void Add(std::string const& name, std::string const& unit, Body body, double min_seconds = -1);
+  std::vector<BenchmarkResult> Run(Options const& options, std::ostream& progress) const;
+
+  static void WriteJson(std::vector<BenchmarkResult> const& results, std::ostream& output);
+  /* Reads back what WriteJson wrote, as name -> rate. */
+  static std::map<std::string, double> ReadJson(std::istream& input);
+  /* Prints each result relative to the baseline. Returns false if any rate fell by more than
+   * threshold (a fraction). */
+  static bool Compare(std::vector<BenchmarkResult> const& results,
+                      std::map<std::string, double> const& baseline, double threshold,
+                      std::ostream& output);
+
+ private:
+  struct Entry {
+    std::string name;
+    std::string unit;
+    Body body;
+    double min_seconds;
+  };
+
+  std::vector<Entry> entries_;
+};
+
+/* Keeps the compiler from discarding a result nobody reads. */
+template <typename T>
+inline void KeepAlive(T const& value) {
+#if defined(__GNUC__)
+  asm volatile("" : : "g"(&value) : "memory");
+#else
+  static T const* volatile sink;
+  sink = &value;
+#endif
+}
+
+#endif
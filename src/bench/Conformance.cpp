@@ -0,0 +1,353 @@
+#include "Conformance.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+#include "ForwardModel.hpp"
+#include "GameServer.hpp"
+#include "IPlayer.hpp"
+#include "Reference.hpp"
+#include "StaticGameController.hpp"
+#include "TextProtocol.hpp"
+
+namespace {
+
+unsigned int constexpr kPods = reference::Game::kPods;
+unsigned int constexpr kPodFields = 9;
+unsigned int constexpr kPlayerFields = 2;
+unsigned int constexpr kFields = kPods * kPodFields + 2 * kPlayerFields + 1;
+
+char const* const kPodFieldNames[kPodFields] = {
+    "x", "y", "vx", "vy", "direction x", "direction y", "lap", "next checkpoint",
+    "shield cooldown"};
+char const* const kPlayerFieldNames[kPlayerFields] = {"timeout", "boosts"};
+
+std::string FieldName(unsigned int field) {
+  if (field < kPods * kPodFields) {
+    return "pod " + std::to_string(field / kPodFields) + " " +
+           kPodFieldNames[field % kPodFields];
+  }
+  field -= kPods * kPodFields;
+  if (field < 2 * kPlayerFields) {
+    return "player " + std::to_string(field / kPlayerFields) + " " +
+           kPlayerFieldNames[field % kPlayerFields];
+  }
+  return "winner";
+}
+
+/* Everything a turn leaves behind, flattened so engines can be compared field by field. */
+struct Snapshot {
+  double values[kFields];
+
+  Snapshot(PodState const (&pods)[kPods], int const (&timeout)[2], int const (&boosts)[2],
+           int winner) {
+    double* value = values;
+    for (PodState const& pod : pods) {
+      for (double field : {pod.position.x(), pod.position.y(), pod.velocity.x(),
+                           pod.velocity.y(), pod.direction.x(), pod.direction.y(),
+                           static_cast<double>(pod.lap),
+                           static_cast<double>(pod.next_checkpoint),
+                           static_cast<double>(pod.shield_cooldown)}) {
+        *value++ = field;
+      }
+    }
+    for (unsigned int p = 0; p < 2; ++p) {
+      *value++ = timeout[p];
+      *value++ = boosts[p];
+    }
+    *value = winner;
+  }
+
+  /* First field that differs, or kFields. NaN matches NaN. */
+  unsigned int Compare(Snapshot const& other) const {
+    for (unsigned int field = 0; field < kFields; ++field) {
+      double a = values[field];
+      double b = other.values[field];
+      if (a != b && !(std::isnan(a) && std::isnan(b))) {
+        return field;
+      }
+    }
+    return kFields;
+  }
+};
+
+Snapshot Take(reference::Game const& game, int winner) {
+  PodState pods[kPods];
+  int timeout[2];
+  int boosts[2];
+  for (unsigned int i = 0; i < kPods; ++i) {
+    reference::Pod const& pod = game.players[i / 2].pods[i % 2];
+    pods[i] = PodState{Vec2(pod.position.x, pod.position.y), Vec2(pod.velocity.x, pod.velocity.y),
+                       Vec2(pod.direction.x, pod.direction.y), pod.lap, pod.next_checkpoint,
+                       pod.shield_cooldown};
+  }
+  for (unsigned int p = 0; p < 2; ++p) {
+    timeout[p] = game.players[p].timeout;
+    boosts[p] = game.players[p].boosts_available;
+  }
+  return Snapshot(pods, timeout, boosts, winner);
+}
+
+Snapshot Take(Scenario const& scenario, int winner) {
+  PodState pods[kPods];
+  int timeout[2];
+  int boosts[2];
+  for (unsigned int i = 0; i < kPods; ++i) {
+    pods[i] = scenario.players[i / 2].pods[i % 2];
+  }
+  for (unsigned int p = 0; p < 2; ++p) {
+    timeout[p] = scenario.players[p].timeout;
+    boosts[p] = scenario.players[p].boosts_available;
+  }
+  return Snapshot(pods, timeout, boosts, winner);
+}
+
+Snapshot Take(ForwardState const& state, int winner) {
+  PodState pods[kPods];
+  for (unsigned int i = 0; i < kPods; ++i) {
+    pods[i] = state.pods[i].GetState();
+  }
+  return Snapshot(pods, state.timeout, state.boosts_available, winner);
+}
+
+/* Writes whatever commands it is given, for driving GameController's real controller path. */
+class ScriptedController : public IPlayer {
+ public:
+  void SetStreams(std::istream& input, std::ostream& output) override { output_ = &output; }
+  void Setup() override {}
+  void Turn() override { output_->write(commands_.data(), commands_.size()); }
+
+  void SetCommands(PodControl const& pod1, PodControl const& pod2) {
+    commands_.clear();
+    for (PodControl const* control : {&pod1, &pod2}) {
+      protocol::AppendInt(commands_, control->x);
+      commands_ += ' ';
+      protocol::AppendInt(commands_, control->y);
+      commands_ += ' ';
+      commands_ += control->action;
+      commands_ += '\n';
+    }
+  }
+
+ private:
+  std::ostream* output_;
+  std::string commands_;
+};
+
+class Fuzzer {
+ public:
+  Fuzzer(uint64_t seed) : random_(seed) {}
+
+  /* A race in progress: crowded starts put every pod near one checkpoint, so collisions,
+   * checkpoint passages and finishes are common rather than rare. */
+  Scenario MakeScenario() {
+    Scenario scenario;
+    unsigned int checkpoints = 2 + Draw(7);
+    while (scenario.map.size() < checkpoints) {
+      Vec2 candidate(Draw(16000), Draw(9000));
+      double closest = INFINITY;
+      for (Vec2 const& checkpoint : scenario.map) {
+        closest = std::min(closest, (checkpoint - candidate).Length());
+      }
+      if (closest > 1200) {
+        scenario.map.push_back(candidate);
+      }
+    }
+
+    scenario.frame = 1 + Draw(300);
+    bool crowded = Draw(2) == 0;
+    Vec2 center = scenario.map[Draw(checkpoints)];
+    for (Scenario::Team& team : scenario.players) {
+      team.timeout = Draw(4) == 0 ? Draw(3) : Draw(101);
+      team.boosts_available = Draw(2);
+      for (PodState& pod : team.pods) {
+        pod.position = crowded ? Vec2(center.x() + Spread(1500), center.y() + Spread(1500))
+                               : Vec2(Draw(16000), Draw(9000));
+        pod.velocity = Draw(4) == 0 ? Vec2() : Vec2(Spread(800), Spread(800));
+        double angle = Draw(3600) * Vec2::pi() / 1800;
+        pod.direction = Vec2(std::cos(angle), std::sin(angle));
+        pod.lap = Draw(4);
+        pod.next_checkpoint = pod.lap == 3 ? 0 : Draw(checkpoints);
+        pod.shield_cooldown = Draw(3) == 0 ? Draw(4) : 0;
+      }
+    }
+    return scenario;
+  }
+
+  /* At random, at the next checkpoint or at another pod, with any action. */
+  PodControl MakeControl(reference::Game const& game, unsigned int i) {
+    reference::Pod const& pod = game.players[i / 2].pods[i % 2];
+    PodControl control;
+    switch (Draw(3)) {
+      case 0:
+        control.x = Draw(20000) - 2000;
+        control.y = Draw(13000) - 2000;
+        break;
+      case 1: {
+        reference::Vector const& checkpoint = game.map[pod.next_checkpoint];
+        control.x = static_cast<int>(checkpoint.x) + Spread(600);
+        control.y = static_cast<int>(checkpoint.y) + Spread(600);
+        break;
+      }
+      default: {
+        unsigned int other = (i + 1 + Draw(kPods - 1)) % kPods;
+        reference::Pod const& target = game.players[other / 2].pods[other % 2];
+        control.x = static_cast<int>(target.position.x + target.velocity.x);
+        control.y = static_cast<int>(target.position.y + target.velocity.y);
+        break;
+      }
+    }
+    /* Aiming at itself normalises a zero vector, which no engine defines. */
+    if (control.x == pod.position.x && control.y == pod.position.y) {
+      control.x++;
+    }
+
+    unsigned int action = Draw(100);
+    if (action < 8) {
+      control.action = "SHIELD";
+    } else if (action < 12) {
+      control.action = "BOOST";
+    } else if (action < 20) {
+      control.action = "0";
+    } else if (action < 50) {
+      control.action = "100";
+    } else {
+      control.action = std::to_string(Draw(101));
+    }
+    return control;
+  }
+
+ private:
+  int Draw(unsigned int range) { return static_cast<int>(random_() % range); }
+  int Spread(int magnitude) { return Draw(2 * magnitude + 1) - magnitude; }
+
+  std::mt19937_64 random_;
+};
+
+}  // namespace
+
+ConformanceReport CheckConformance(unsigned int cases, unsigned int turns, uint64_t seed) {
+  enum { kGameController, kStaticGameController, kStep, kStepCandidates, kEngines };
+  ConformanceReport report;
+  report.engines.resize(kEngines);
+  report.engines[kGameController].name = "GameController";
+  report.engines[kStaticGameController].name = "StaticGameController";
+  report.engines[kStep].name = "ForwardModel::Step";
+  report.engines[kStepCandidates].name = "ForwardModel::StepCandidates";
+
+  ScriptedController scripts[2];
+  GameController controller;
+  controller.AddPlayer(scripts[0]);
+  controller.AddPlayer(scripts[1]);
+  ScriptedController static_scripts[2];
+  StaticGameController<2, ScriptedController, ScriptedController> static_controller(
+      static_scripts[0], static_scripts[1]);
+  std::vector<PodControl> candidates(3);
+  std::vector<ForwardState> results;
+  std::vector<int> winners;
+  reference::Events events;
+
+  for (unsigned int game_case = 0; game_case < cases; ++game_case) {
+    Fuzzer fuzzer(seed + game_case);
+    Scenario start = fuzzer.MakeScenario();
+    reference::Game game = reference::Game::FromScenario(start);
+    Scenario scenario = start;
+    Scenario static_scenario = start;
+    ForwardModel model(start.map);
+    ForwardState stepped = ForwardState::FromScenario(start);
+    ForwardState candidate_stepped = stepped;
+    bool diverged[kEngines] = {};
+    report.cases++;
+
+    for (unsigned int turn = 0; turn < turns; ++turn) {
+      PodControl controls[kPods];
+      for (unsigned int i = 0; i < kPods; ++i) {
+        controls[i] = fuzzer.MakeControl(game, i);
+      }
+      /* The candidate engine's pod plays controls[pod] among decoys. */
+      unsigned int pod = turn % kPods;
+      candidates = {fuzzer.MakeControl(game, pod), controls[pod], fuzzer.MakeControl(game, pod)};
+
+      int winner = game.Turn(controls, false, events);
+      Snapshot expected = Take(game, winner);
+      report.turns++;
+
+      for (unsigned int engine = 0; engine < kEngines; ++engine) {
+        if (diverged[engine]) {
+          continue;
+        }
+        int actual_winner;
+        if (engine == kGameController) {
+          scripts[0].SetCommands(controls[0], controls[1]);
+          scripts[1].SetCommands(controls[2], controls[3]);
+          actual_winner = controller.RunScenario(scenario, 1);
+          scenario = controller.CaptureScenario();
+        } else if (engine == kStaticGameController) {
+          static_scripts[0].SetCommands(controls[0], controls[1]);
+          static_scripts[1].SetCommands(controls[2], controls[3]);
+          actual_winner = static_controller.RunScenario(static_scenario, 1);
+          static_scenario = static_controller.CaptureScenario();
+        } else if (engine == kStep) {
+          actual_winner = model.Step(stepped, controls);
+        } else {
+          model.StepCandidates(candidate_stepped, controls, pod, candidates, results, winners);
+          candidate_stepped = results[1];
+          actual_winner = winners[1];
+        }
+        Snapshot actual = engine == kStep             ? Take(stepped, actual_winner)
+                          : engine == kStepCandidates ? Take(candidate_stepped, actual_winner)
+                          : engine == kGameController ? Take(scenario, actual_winner)
+                                                      : Take(static_scenario, actual_winner);
+
+        unsigned int field = expected.Compare(actual);
+        if (field == kFields) {
+          continue;
+        }
+        diverged[engine] = true;
+        ConformanceReport::Engine& result = report.engines[engine];
+        if (result.diverged_cases++ == 0) {
+          result.first = {game_case, turn, FieldName(field), expected.values[field],
+                          actual.values[field]};
+        }
+      }
+
+      if (winner != -1) {
+        break;
+      }
+    }
+  }
+
+  report.checkpoints = events.checkpoints;
+  report.collisions = events.collisions;
+  report.shields = events.shields;
+  report.boosts = events.boosts;
+  return report;
+}
+
+bool ConformanceReport::passed() const {
+  for (Engine const& engine : engines) {
+    if (engine.diverged_cases > 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void ConformanceReport::Print(std::ostream& output) const {
+  std::streamsize precision = output.precision(17);
+  output << "conformance: " << cases << " cases, " << turns << " turns (" << checkpoints
+         << " checkpoints, " << collisions << " collisions, " << shields << " shields, "
+         << boosts << " boosts)" << std::endl;
+  for (Engine const& engine : engines) {
+    output << "  " << engine.name << ": ";
+    if (engine.diverged_cases == 0) {
+      output << "matches the reference" << std::endl;
+      continue;
+    }
+    output << engine.diverged_cases << " of " << cases << " cases diverge, first case "
+           << engine.first.game_case << " turn " << engine.first.turn << " at "
+           << engine.first.field << ": reference " << engine.first.expected << ", engine "
+           << engine.first.actual << " -- NOT CONFORMING" << std::endl;
+  }
+  output.precision(precision);
+}
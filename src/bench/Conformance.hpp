@@ -0,0 +1,42 @@
+#ifndef CONFORMANCE_HPP
+#define CONFORMANCE_HPP
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/* Differential fuzzing of the engines against reference::Game: random mid-race states and
+ * random commands, played turn by turn by the reference and by each engine from the same start,
+ * with every pod and player field compared after every turn. */
+struct ConformanceReport {
+  /* Where an engine first parted from the reference. Case k is seeded with seed + k. */
+  struct Divergence {
+    unsigned int game_case = 0;
+    unsigned int turn = 0;
+    std::string field;
+    double expected = 0.0;
+    double actual = 0.0;
+  };
+  struct Engine {
+    std::string name;
+    unsigned int diverged_cases = 0;
+    Divergence first; /* of the lowest diverged case */
+  };
+
+  unsigned int cases = 0;
+  unsigned long turns = 0; /* reference turns; each engine plays the same ones */
+  /* What the reference did over them, to show which rules the cases reached. */
+  unsigned long checkpoints = 0;
+  unsigned long collisions = 0;
+  unsigned long shields = 0;
+  unsigned long boosts = 0;
+  std::vector<Engine> engines;
+
+  bool passed() const;
+  void Print(std::ostream& output) const;
+};
+
+ConformanceReport CheckConformance(unsigned int cases, unsigned int turns, uint64_t seed);
+
+#endif
@@ -0,0 +1,155 @@
+#include "Precision.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "ForwardModel.hpp"
+
+namespace {
+
+unsigned int constexpr kMaxTurns = 600;
+
+/* Counter-based, so both precisions draw the same noise for the same game, turn and pod. */
+uint64_t Mix(uint64_t x) {
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdull;
+  x ^= x >> 33;
+  x *= 0xc4ceb9fe1a85ec53ull;
+  return x ^ (x >> 33);
+}
+
+struct Start {
+  std::vector<Vec2> map;
+  PodState pods[ForwardState::kPods];
+};
+
+/* A map and starting grid drawn the way GameController::InitMap and InitPods draw them. */
+Start MakeStart(uint64_t seed) {
+  Start start;
+  unsigned int draws = 0;
+  auto draw = [&](unsigned int range) { return Mix(seed * 1000003 + draws++) % range; };
+
+  unsigned int checkpoints = 2 + draw(7);
+  while (start.map.size() < checkpoints) {
+    Vec2 candidate(draw(16000), draw(9000));
+    double closest = INFINITY;
+    for (auto const& checkpoint : start.map) {
+      closest = std::min(closest, (checkpoint - candidate).Length());
+    }
+    if (closest > 1200) {
+      start.map.push_back(candidate);
+    }
+  }
+
+  Vec2 line = Vec2::Perpendicular(start.map[1] - start.map[0]);
+  line.Normalize();
+  bool inside = draw(2) == 0;
+  for (unsigned int i = 0; i < ForwardState::kPods; ++i) {
+    double offset = (i / 2 == 0) == inside ? 500 : 1500;
+    Pod pod;
+    pod.SetPosition(start.map[0], line, i % 2 == 0 ? offset : -offset);
+    pod.PointAt(start.map[1]);
+    start.pods[i] = pod.GetState();
+  }
+  return start;
+}
+
+struct Log {
+  int winner = -1;
+  std::vector<int> positions;                     /* x and y of each pod, every turn */
+  std::vector<int> passages[ForwardState::kPods]; /* turn of each checkpoint passage */
+};
+
+template <typename T>
+Log Play(Start const& start, uint64_t seed) {
+  ForwardModelT<T> model(start.map);
+  ForwardStateT<T> state;
+  for (unsigned int i = 0; i < ForwardState::kPods; ++i) {
+    state.pods[i].SetState(start.pods[i]);
+  }
+
+  Log log;
+  for (unsigned int turn = 0; turn < kMaxTurns && log.winner == -1; ++turn) {
+    PodControl controls[ForwardState::kPods];
+    for (unsigned int i = 0; i < ForwardState::kPods; ++i) {
+      uint64_t noise = Mix(seed * 1000003 + turn * 4 + i + 0x51ed);
+      controls[i] = model.Predict(state.pods[i]);
+      controls[i].x += static_cast<int>(noise % 3001) - 1500;
+      controls[i].y += static_cast<int>((noise >> 16) % 3001) - 1500;
+      unsigned int action = (noise >> 32) % 100;
+      if (action < 3) {
+        controls[i].action = "SHIELD";
+      } else if (action < 5) {
+        controls[i].action = "BOOST";
+      } else if (action < 30) {
+        controls[i].action = std::to_string((noise >> 40) % 101);
+      }
+    }
+
+    log.winner = model.Step(state, controls, turn == 0);
+    for (unsigned int i = 0; i < ForwardState::kPods; ++i) {
+      PodT<T> const& pod = state.pods[i];
+      log.positions.push_back(static_cast<int>(pod.position().x()));
+      log.positions.push_back(static_cast<int>(pod.position().y()));
+      if (pod.made_progress()) {
+        log.passages[i].push_back(turn);
+      }
+    }
+  }
+  return log;
+}
+
+}  // namespace
+
+PrecisionReport ComparePrecision(unsigned int games, uint64_t seed) {
+  PrecisionReport report;
+  double divergence_turns = 0.0;
+  double checkpoint_error = 0.0;
+  unsigned long matched = 0;
+  for (unsigned int game = 0; game < games; ++game) {
+    uint64_t game_seed = seed + game;
+    Start start = MakeStart(game_seed);
+    Log exact = Play<double>(start, game_seed);
+    Log approx = Play<float>(start, game_seed);
+
+    report.games++;
+    report.winner_mismatches += exact.winner != approx.winner;
+    auto diverged = std::mismatch(exact.positions.begin(), exact.positions.end(),
+                                  approx.positions.begin(), approx.positions.end());
+    if (diverged.first != exact.positions.end() || diverged.second != approx.positions.end()) {
+      report.diverged_games++;
+      divergence_turns += (diverged.first - exact.positions.begin()) / (2 * ForwardState::kPods);
+    }
+
+    for (unsigned int i = 0; i < ForwardState::kPods; ++i) {
+      for (unsigned int k = 0; k < exact.passages[i].size(); ++k) {
+        report.checkpoints++;
+        if (k >= approx.passages[i].size()) {
+          report.checkpoint_mismatches++;
+          continue;
+        }
+        int error = std::abs(exact.passages[i][k] - approx.passages[i][k]);
+        report.checkpoint_mismatches += error != 0;
+        checkpoint_error += error;
+        matched++;
+      }
+    }
+  }
+
+  if (report.diverged_games > 0) {
+    report.mean_divergence_turn = divergence_turns / report.diverged_games;
+  }
+  if (matched > 0) {
+    report.mean_checkpoint_error = checkpoint_error / matched;
+  }
+  return report;
+}
+
+void PrecisionReport::Print(std::ostream& output) const {
+  output << "float physics: " << winner_mismatches << " of " << games
+         << " winners differ, " << diverged_games << " games diverge (first at turn "
+         << mean_divergence_turn << " on average), " << checkpoint_mismatches << " of "
+         << checkpoints << " checkpoint passages on another turn (mean error "
+         << mean_checkpoint_error << " turns)" << std::endl;
+}
@@ -0,0 +1,26 @@
+#ifndef PRECISION_HPP
+#define PRECISION_HPP
+
+#include <cstdint>
+#include <iostream>
+
+/* How far ForwardModelT<float> drifts from the double engine: the same seeded games, maps, starts
+ * and (state-dependent) commands, played once in each precision. */
+struct PrecisionReport {
+  unsigned int games = 0;
+  unsigned int winner_mismatches = 0;
+  /* Games whose rounded positions ever differ, and the mean turn of the first difference. */
+  unsigned int diverged_games = 0;
+  double mean_divergence_turn = 0.0;
+  /* Checkpoint passages of the double games, and how many the float games made on another turn
+   * or not at all. */
+  unsigned long checkpoints = 0;
+  unsigned long checkpoint_mismatches = 0;
+  double mean_checkpoint_error = 0.0; /* turns, over passages both games made */
+
+  void Print(std::ostream& output) const;
+};
+
+PrecisionReport ComparePrecision(unsigned int games, uint64_t seed);
+
+#endif
@@ -0,0 +1,284 @@
+#include "Reference.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace reference {
+
+namespace {
+
+double const kPi = std::atan(1) * 4;
+
+Vector Add(Vector a, Vector b) { return {a.x + b.x, a.y + b.y}; }
+Vector Subtract(Vector a, Vector b) { return {a.x - b.x, a.y - b.y}; }
+Vector Scale(Vector a, double scalar) { return {a.x * scalar, a.y * scalar}; }
+double Dot(Vector a, Vector b) { return a.x * b.x + a.y * b.y; }
+double Cross(Vector a, Vector b) { return a.x * b.y - a.y * b.x; }
+double Length(Vector a) { return std::sqrt(Dot(a, a)); }
+
+Vector Rotate(Vector a, double angle) {
+  return {std::cos(angle) * a.x - std::sin(angle) * a.y,
+          std::sin(angle) * a.x + std::cos(angle) * a.y};
+}
+
+int GetBoost(Pod& pod, PodControl const& control, int& boosts_available, Events& events) {
+  if (control.action == "SHIELD") {
+    pod.mass = 10;
+    pod.shield_cooldown = 4;
+    events.shields++;
+  } else {
+    pod.mass = 1;
+  }
+  if (pod.shield_cooldown > 0) {
+    return 0;
+  }
+  if (control.action == "BOOST") {
+    if (boosts_available > 0) {
+      boosts_available--;
+      events.boosts++;
+      return 650;
+    }
+    return 100;
+  }
+  return std::atoi(control.action.c_str());
+}
+
+void SetTurnConditions(Pod& pod, PodControl const& control, int& boosts_available,
+                       bool first_frame, Events& events) {
+  double const max_angle = kPi / 10;
+
+  int boost = GetBoost(pod, control, boosts_available, events);
+  if (pod.shield_cooldown > 0) {
+    pod.shield_cooldown--;
+  }
+
+  Vector desired = Subtract({static_cast<double>(control.x), static_cast<double>(control.y)},
+                            pod.position);
+  desired = Scale(desired, 1.0 / Length(desired));
+  double dot = std::max(-1.0, std::min(Dot(pod.direction, desired), 1.0));
+
+  double angle = std::acos(dot);
+  if (angle < max_angle || first_frame) {
+    pod.direction = desired;
+  } else {
+    double cross = Cross(pod.direction, desired);
+    pod.direction = Rotate(pod.direction, cross > 0 ? max_angle : -max_angle);
+  }
+
+  pod.velocity = Add(pod.velocity, Scale(pod.direction, boost));
+  pod.made_progress = false;
+  pod.progress_time = 0.0;
+}
+
+void MakeProgress(Pod& pod, double dt, unsigned int checkpoint_count) {
+  pod.made_progress = true;
+  pod.progress_time = dt;
+  pod.next_checkpoint++;
+  if (pod.next_checkpoint >= checkpoint_count) {
+    pod.next_checkpoint = 0;
+    pod.lap++;
+  }
+}
+
+void CollidePods(Pod& pod1, Pod& pod2) {
+  Vector dp = Subtract(pod2.position, pod1.position);
+  Vector dv = Subtract(pod2.velocity, pod1.velocity);
+  double m =
+      static_cast<double>(pod1.mass + pod2.mass) / static_cast<double>(pod1.mass * pod2.mass);
+
+  double seperation2 = Length(dp) * Length(dp);
+  Vector f = Scale(dp, Dot(dp, dv) / (seperation2 * m));
+
+  pod1.velocity = Add(pod1.velocity, Scale(f, 1.0 / pod1.mass));
+  pod2.velocity = Subtract(pod2.velocity, Scale(f, 1.0 / pod2.mass));
+
+  /* The original kept the impulse in a float. */
+  float impulse = Length(f);
+  if (impulse < 120.0) {
+    f = Scale(f, 120.0 / impulse);
+  }
+
+  pod1.velocity = Add(pod1.velocity, Scale(f, 1.0 / pod1.mass));
+  pod2.velocity = Subtract(pod2.velocity, Scale(f, 1.0 / pod2.mass));
+}
+
+void EndTurn(Pod& pod) {
+  pod.velocity = Scale(pod.velocity, 0.85);
+  pod.velocity.x = pod.velocity.x > 0 ? std::floor(pod.velocity.x) : std::ceil(pod.velocity.x);
+  pod.velocity.y = pod.velocity.y > 0 ? std::floor(pod.velocity.y) : std::ceil(pod.velocity.y);
+  pod.position.x = std::round(pod.position.x);
+  pod.position.y = std::round(pod.position.y);
+}
+
+bool GetNextCollision(Vector p1, Vector v1, double r1, Vector p2, Vector v2, double r2,
+                      double& dt) {
+  Vector dp = Subtract(p2, p1);
+  Vector dv = Subtract(v2, v1);
+  double r = r1 + r2;
+
+  double a = Dot(dv, dv);
+  double b = 2 * Dot(dv, dp);
+  double c = Dot(dp, dp) - r * r;
+  double disc = b * b - 4 * a * c;
+  if (disc < 0) {
+    return false;
+  }
+  if (a == 0) {
+    if (c < 0) {
+      dt = 0.0;
+      return true;
+    }
+    return false;
+  }
+
+  double t1 = (-b + std::sqrt(disc)) / (2 * a);
+  double t2 = (-b - std::sqrt(disc)) / (2 * a);
+  double t = std::min(t1, t2);
+  if (t < 0) {
+    return false;
+  }
+  dt = t;
+  return true;
+}
+
+}  // namespace
+
+Game Game::FromScenario(Scenario const& scenario) {
+  Game game;
+  for (Vec2 const& checkpoint : scenario.map) {
+    game.map.push_back({checkpoint.x(), checkpoint.y()});
+  }
+  for (unsigned int p = 0; p < 2; ++p) {
+    Scenario::Team const& source = scenario.players[p];
+    Team& team = game.players[p];
+    team.timeout = source.timeout;
+    team.boosts_available = source.boosts_available;
+    for (unsigned int i = 0; i < 2; ++i) {
+      PodState const& state = source.pods[i];
+      Pod& pod = team.pods[i];
+      pod.position = {state.position.x(), state.position.y()};
+      pod.velocity = {state.velocity.x(), state.velocity.y()};
+      pod.direction = {state.direction.x(), state.direction.y()};
+      pod.lap = state.lap;
+      pod.next_checkpoint = state.next_checkpoint;
+      pod.shield_cooldown = state.shield_cooldown;
+    }
+  }
+  return game;
+}
+
+int Game::Turn(PodControl const (&controls)[kPods], bool first_frame, Events& events) {
+  Pod* pods[kPods];
+  for (unsigned int i = 0; i < kPods; ++i) {
+    Team& team = players[i / 2];
+    pods[i] = &team.pods[i % 2];
+    SetTurnConditions(*pods[i], controls[i], team.boosts_available, first_frame, events);
+  }
+
+  double turn_time_remaining = 1.0;
+  for (unsigned int t = 0; t < 1000; ++t) {
+    double dt_checkpoint = 2.0;
+    Pod* pod_checkpoint = nullptr;
+    for (unsigned int i = 0; i < kPods; ++i) {
+      double time;
+      Vector checkpoint = map.at(pods[i]->next_checkpoint);
+      if (GetNextCollision(pods[i]->position, pods[i]->velocity, 0, checkpoint, Vector(), 600,
+                           time) &&
+          time < 1.0 && time < dt_checkpoint) {
+        dt_checkpoint = time;
+        pod_checkpoint = pods[i];
+      }
+    }
+
+    double dt_pod = 2.0;
+    Pod* pod_collision_1 = nullptr;
+    Pod* pod_collision_2 = nullptr;
+    for (unsigned int i = 0; i < kPods - 1; ++i) {
+      for (unsigned int j = i + 1; j < kPods; ++j) {
+        double time;
+        if (GetNextCollision(pods[i]->position, pods[i]->velocity, 400, pods[j]->position,
+                             pods[j]->velocity, 400, time) &&
+            time < 1.0 && time < dt_pod) {
+          dt_pod = time;
+          pod_collision_1 = pods[i];
+          pod_collision_2 = pods[j];
+        }
+      }
+    }
+
+    bool checkpoint_collision = pod_checkpoint != nullptr;
+    bool pod_collision = pod_collision_1 != nullptr;
+    if (checkpoint_collision && pod_collision) {
+      if (dt_checkpoint < dt_pod) {
+        pod_collision = false;
+      } else {
+        checkpoint_collision = false;
+      }
+    }
+
+    double dt = checkpoint_collision ? dt_checkpoint : dt_pod;
+    if ((checkpoint_collision || pod_collision) && dt <= turn_time_remaining) {
+      for (Pod* pod : pods) {
+        pod->position = Add(pod->position, Scale(pod->velocity, dt));
+      }
+      turn_time_remaining -= dt;
+      if (checkpoint_collision) {
+        MakeProgress(*pod_checkpoint, dt, map.size());
+        events.checkpoints++;
+      } else {
+        CollidePods(*pod_collision_1, *pod_collision_2);
+        events.collisions++;
+      }
+      continue;
+    }
+    break;
+  }
+
+  for (Team& team : players) {
+    bool progress = false;
+    for (Pod& pod : team.pods) {
+      pod.position = Add(pod.position, Scale(pod.velocity, turn_time_remaining));
+      if (pod.made_progress) {
+        progress = true;
+        if (pod.lap >= 3 && pod.next_checkpoint == 1) {
+          team.has_won = true;
+          team.win_time = pod.progress_time;
+        }
+      }
+      EndTurn(pod);
+    }
+
+    if (progress) {
+      team.timeout = 100;
+    } else if (team.timeout > 0) {
+      team.timeout--;
+    } else {
+      team.has_lost = true;
+    }
+  }
+
+  /* GameController::GetWinner: the earliest finish, player 0 on a tie; else the last player not
+   * timed out. */
+  int winner = -1;
+  double win_time = 2.0;
+  unsigned int lost = 0;
+  for (unsigned int p = 0; p < 2; ++p) {
+    if (players[p].has_won && players[p].win_time < win_time) {
+      win_time = players[p].win_time;
+      winner = p;
+    }
+    lost += players[p].has_lost;
+  }
+  if (winner != -1) {
+    return winner;
+  }
+  if (lost == 2) {
+    return -2;
+  }
+  if (lost == 1) {
+    return players[0].has_lost ? 1 : 0;
+  }
+  return -1;
+}
+
+}  // namespace reference
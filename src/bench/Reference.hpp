@@ -0,0 +1,63 @@
+#ifndef REFERENCE_HPP
+#define REFERENCE_HPP
+
+#include <vector>
+#include "Pod.hpp"
+#include "Scenario.hpp"
+
+/* The referee's turn rules exactly as the original GameController, Player and Pod played them:
+ * plain double arithmetic, acos for the turn limit, every collision solved every sub-step. The
+ * conformance fuzzer checks the optimised engines against it, so it is frozen: it must not share
+ * code with the engine or be optimised itself, and changes here are rule changes. */
+namespace reference {
+
+struct Vector {
+  double x = 0.0;
+  double y = 0.0;
+};
+
+struct Pod {
+  Vector position;
+  Vector velocity;
+  Vector direction;
+  int lap = 0;
+  unsigned int next_checkpoint = 1;
+  int shield_cooldown = 0;
+  int mass = 1;
+  bool made_progress = false;
+  double progress_time = 0.0;
+};
+
+struct Team {
+  Pod pods[2];
+  int timeout = 100;
+  int boosts_available = 1;
+  bool has_won = false;
+  double win_time = 1.0;
+  bool has_lost = false;
+};
+
+/* Counts of what the rules did, so a fuzzer can tell which of them it reached. */
+struct Events {
+  unsigned long checkpoints = 0;
+  unsigned long collisions = 0;
+  unsigned long shields = 0;
+  unsigned long boosts = 0;
+};
+
+struct Game {
+  static unsigned int constexpr kPods = 4;
+
+  std::vector<Vector> map;
+  Team players[2];
+
+  static Game FromScenario(Scenario const& scenario);
+
+  /* Plays one turn, controls[i] driving pod i % 2 of player i / 2. Returns the winner (0 or 1),
+   * -2 if both players lost, else -1. */
+  int Turn(PodControl const (&controls)[kPods], bool first_frame, Events& events);
+};
+
+}  // namespace reference
+
+#endif
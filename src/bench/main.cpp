@@ -0,0 +1,710 @@
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "Benchmark.hpp"
+#include "BlockerConfigFactory.hpp"
+#include "Conformance.hpp"
+#include "DualAdvancedRunner.hpp"
+#include "DualSimpleRunner.hpp"
+#include "ExternalBot.hpp"
+#include "FastMath.hpp"
+#include "ForwardModel.hpp"
+#include "GameServer.hpp"
+#include "GeneticAlgorithm.hpp"
+#include "NeuralNetwork.hpp"
+#include "NeuralNetworkFactory.hpp"
+#include "Pod.hpp"
+#include "Precision.hpp"
+#include "RunnerBlocker.hpp"
+#include "SearchRunner.hpp"
+#include "StaticGameController.hpp"
+#include "TextProtocol.hpp"
+#include "TrainedNetworks.hpp"
+
+static double Uniform(double low, double high) {
+  return low + (high - low) * std::rand() / static_cast<double>(RAND_MAX);
+}
+
+static void AddCollisionBenchmarks(BenchmarkSuite& suite) {
+  static unsigned int constexpr kPairs = 4096;
+
+  /* Pods scattered over the map with race-like speeds, so both hit and miss branches run. */
+  struct Pair {
+    Vec2 p1, v1, p2, v2;
+  };
+  auto pairs = std::make_shared<std::vector<Pair>>();
+  for (unsigned int i = 0; i < kPairs; ++i) {
+    Vec2 p1(Uniform(0, 16000), Uniform(0, 9000));
+    Vec2 p2 = p1 + Vec2(Uniform(-2000, 2000), Uniform(-2000, 2000));
+    pairs->push_back({p1, Vec2(Uniform(-800, 800), Uniform(-800, 800)), p2,
+                      Vec2(Uniform(-800, 800), Uniform(-800, 800))});
+  }
+  suite.Add("engine.next_collision", "solves", [pairs]() {
+    unsigned long hits = 0;
+    for (auto const& pair : *pairs) {
+      /* dt is only written on a hit. */
+      double dt;
+      if (GameController::GetNextCollision(pair.p1, pair.v1, 400, pair.p2, pair.v2, 400, dt)) {
+        hits++;
+        KeepAlive(dt);
+      }
+    }
+    KeepAlive(hits);
+    return pairs->size();
+  });
+
+  /* Pods touching and closing on each other, as they are when CollidePods is called. */
+  auto pods = std::make_shared<std::vector<Pod>>();
+  for (unsigned int i = 0; i < kPairs; ++i) {
+    Vec2 p(Uniform(0, 16000), Uniform(0, 9000));
+    Vec2 normal(Uniform(-1, 1), Uniform(-1, 1));
+    normal.Normalize();
+    PodState a = {p, normal * Uniform(0, 600), Vec2(1, 0), 0, 1, 0};
+    PodState b = {p + normal * 800, normal * -Uniform(0, 600), Vec2(-1, 0), 0, 1, 0};
+    pods->push_back(Pod());
+    pods->back().SetState(a);
+    pods->push_back(Pod());
+    pods->back().SetState(b);
+  }
+  suite.Add("engine.collide_pods", "collisions", [pods]() {
+    std::vector<Pod> work = *pods;
+    for (unsigned int i = 0; i + 1 < work.size(); i += 2) {
+      Pod::CollidePods(work[i], work[i + 1]);
+    }
+    KeepAlive(work);
+    return work.size() / 2;
+  });
+}
+
+static void AddForwardModelBenchmarks(BenchmarkSuite& suite) {
+  static unsigned int constexpr kStates = 256;
+  static unsigned int constexpr kCandidates = 16;
+
+  /* Pods close together near a checkpoint, so the collision search has work to do. */
+  std::vector<Vec2> map;
+  for (unsigned int i = 0; i < 4; ++i) {
+    map.push_back(Vec2(Uniform(1000, 15000), Uniform(1000, 8000)));
+  }
+  auto model = std::make_shared<ForwardModel>(map);
+  auto states = std::make_shared<std::vector<ForwardState>>(kStates);
+  for (auto& state : *states) {
+    Vec2 center = map[1] + Vec2(Uniform(-3000, 3000), Uniform(-3000, 3000));
+    for (auto& pod : state.pods) {
+      Vec2 direction(Uniform(-1, 1), Uniform(-1, 1));
+      direction.Normalize();
+      PodState pod_state = {center + Vec2(Uniform(-1500, 1500), Uniform(-1500, 1500)),
+                            direction * Uniform(0, 700), direction, 0, 1, 0};
+      pod.SetState(pod_state);
+    }
+  }
+  auto float_states = std::make_shared<std::vector<ForwardStateT<float>>>(kStates);
+  for (unsigned int s = 0; s < kStates; ++s) {
+    for (unsigned int i = 0; i < ForwardState::kPods; ++i) {
+      (*float_states)[s].pods[i].SetState((*states)[s].pods[i].GetState());
+    }
+  }
+  auto candidates = std::make_shared<std::vector<PodControl>>();
+  for (unsigned int i = 0; i < kCandidates; ++i) {
+    candidates->push_back({static_cast<int>(Uniform(0, 16000)), static_cast<int>(Uniform(0, 9000)),
+                           i % 8 == 0 ? "SHIELD" : std::to_string(i * 100 / kCandidates)});
+  }
+
+  suite.Add("engine.forward_step", "candidates", [model, states, candidates]() {
+    for (auto const& state : *states) {
+      PodControl controls[ForwardState::kPods];
+      for (unsigned int i = 0; i < ForwardState::kPods; ++i) {
+        controls[i] = model->Predict(state.pods[i]);
+      }
+      for (auto const& candidate : *candidates) {
+        ForwardState next = state;
+        controls[0] = candidate;
+        KeepAlive(model->Step(next, controls));
+        KeepAlive(next);
+      }
+    }
+    return states->size() * candidates->size();
+  });
+
+  auto float_model = std::make_shared<ForwardModelT<float>>(map);
+  suite.Add("engine.forward_step_float", "candidates", [float_model, float_states, candidates]() {
+    for (auto const& state : *float_states) {
+      PodControl controls[ForwardState::kPods];
+      for (unsigned int i = 0; i < ForwardState::kPods; ++i) {
+        controls[i] = float_model->Predict(state.pods[i]);
+      }
+      for (auto const& candidate : *candidates) {
+        ForwardStateT<float> next = state;
+        controls[0] = candidate;
+        KeepAlive(float_model->Step(next, controls));
+        KeepAlive(next);
+      }
+    }
+    return float_states->size() * candidates->size();
+  });
+
+  suite.Add("engine.step_candidates", "candidates", [model, states, candidates]() {
+    std::vector<ForwardState> results;
+    std::vector<int> winners;
+    for (auto const& state : *states) {
+      PodControl controls[ForwardState::kPods];
+      for (unsigned int i = 0; i < ForwardState::kPods; ++i) {
+        controls[i] = model->Predict(state.pods[i]);
+      }
+      model->StepCandidates(state, controls, 0, *candidates, results, winners);
+      KeepAlive(results);
+    }
+    return states->size() * candidates->size();
+  });
+}
+
+static void AddMathBenchmarks(BenchmarkSuite& suite) {
+  static unsigned int constexpr kValues = 4096;
+
+  /* Vectors as Degrees sees them: velocities and offsets to checkpoints. */
+  auto vectors = std::make_shared<std::vector<Vec2>>();
+  auto angles = std::make_shared<std::vector<double>>();
+  for (unsigned int i = 0; i < kValues; ++i) {
+    vectors->push_back(Vec2(std::round(Uniform(-8000, 8000)), std::round(Uniform(-8000, 8000))));
+    angles->push_back(Uniform(-fastmath::kPi, 3 * fastmath::kPi));
+  }
+
+  suite.Add("math.degrees_exact", "angles", [vectors]() {
+    int sum = 0;
+    for (auto const& v : *vectors) {
+      sum += fastmath::Degrees<fastmath::ExactAtan>(v.x(), v.y());
+    }
+    KeepAlive(sum);
+    return vectors->size();
+  });
+  suite.Add("math.degrees_approx", "angles", [vectors]() {
+    int sum = 0;
+    for (auto const& v : *vectors) {
+      sum += fastmath::Degrees<fastmath::ApproxAtan>(v.x(), v.y());
+    }
+    KeepAlive(sum);
+    return vectors->size();
+  });
+  suite.Add("math.sincos_exact", "angles", [angles]() {
+    double sum = 0;
+    for (double angle : *angles) {
+      sum += fastmath::ExactCos(angle) + fastmath::ExactSin(angle);
+    }
+    KeepAlive(sum);
+    return angles->size();
+  });
+  suite.Add("math.sincos_approx", "angles", [angles]() {
+    double sum = 0;
+    for (double angle : *angles) {
+      sum += fastmath::ApproxCos(angle) + fastmath::ApproxSin(angle);
+    }
+    KeepAlive(sum);
+    return angles->size();
+  });
+}
+
+/* Compares the FAST_MATH approximations with the standard library where the protocol can see
+ * them: whole-degree headings out of Degrees, and whole-unit targets out of a heading. */
+static bool CheckMathAccuracy(std::ostream& output) {
+  static int constexpr kRange = 600;
+  static double constexpr kTargetDistance = 10000;
+
+  unsigned long degrees = 0;
+  unsigned long degree_mismatches = 0;
+  int max_degree_error = 0;
+  auto compare_degrees = [&](double x, double y) {
+    int exact = fastmath::Degrees<fastmath::ExactAtan>(x, y);
+    int approx = fastmath::Degrees<fastmath::ApproxAtan>(x, y);
+    int error = std::abs(exact - approx);
+    error = std::min(error, 360 - error);
+    degrees++;
+    degree_mismatches += error != 0;
+    max_degree_error = std::max(max_degree_error, error);
+  };
+  for (int x = -kRange; x <= kRange; ++x) {
+    for (int y = -kRange; y <= kRange; ++y) {
+      if (x != 0 || y != 0) {
+        compare_degrees(x, y);
+      }
+    }
+  }
+  for (unsigned int i = 0; i < 1000000; ++i) {
+    compare_degrees(std::round(Uniform(-16000, 16000)), std::round(Uniform(-9000, 9000)));
+  }
+
+  double max_trig_error = 0;
+  for (int i = -1000000; i <= 1000000; ++i) {
+    double angle = i * 4 * fastmath::kPi / 1000000;
+    max_trig_error = std::max(max_trig_error,
+                              std::fabs(fastmath::ApproxSin(angle) - fastmath::ExactSin(angle)));
+    max_trig_error = std::max(max_trig_error,
+                              std::fabs(fastmath::ApproxCos(angle) - fastmath::ExactCos(angle)));
+  }
+
+  /* Controllers aim at heading + turn, turn in tenths of a degree, kTargetDistance away. */
+  unsigned long target_mismatches = 0;
+  int max_target_error = 0;
+  for (int tenths = -1800; tenths < 5400; ++tenths) {
+    double angle = tenths / 10.0 * fastmath::kPi / 180;
+    int x[2] = {static_cast<int>(fastmath::ExactCos(angle) * kTargetDistance),
+                static_cast<int>(fastmath::ApproxCos(angle) * kTargetDistance)};
+    int y[2] = {static_cast<int>(fastmath::ExactSin(angle) * kTargetDistance),
+                static_cast<int>(fastmath::ApproxSin(angle) * kTargetDistance)};
+    int error = std::max(std::abs(x[0] - x[1]), std::abs(y[0] - y[1]));
+    target_mismatches += error != 0;
+    max_target_error = std::max(max_target_error, error);
+  }
+
+  bool passed = max_degree_error <= 1 && degree_mismatches * 1000 <= degrees &&
+                max_trig_error < 1e-6 && max_target_error <= 1;
+  output << "fast math: Degrees differs on " << degree_mismatches << " of " << degrees
+         << " vectors (max " << max_degree_error << " degree), sin/cos max error "
+         << max_trig_error << ", targets differ on " << target_mismatches
+         << " of 7200 headings (max " << max_target_error << " unit)"
+         << (passed ? "" : " -- OUT OF BOUNDS") << std::endl;
+  return passed;
+}
+
+/* StaticGameController is the trainer's default full evaluation, so it must play GameController's
+ * game: the trainer's controllers on the same seeded maps, compared by winner and exact fitness. */
+static bool CheckStaticGames(unsigned int games, std::ostream& output) {
+  NeuralNetwork network(advanced_runner);
+  unsigned int mismatches = 0;
+  unsigned int first_mismatch = 0;
+  for (unsigned int game = 0; game < games; ++game) {
+    DualAdvancedRunner runner(network);
+    RunnerBlocker blocker((RunnerBlocker::Config()));
+
+    std::srand(1234 + game);
+    GameController dynamic_game;
+    dynamic_game.AddPlayer(runner);
+    dynamic_game.AddPlayer(blocker);
+    int dynamic_winner = dynamic_game.RunGame();
+
+    runner.Reset();
+    blocker.Reset();
+    std::srand(1234 + game);
+    StaticGameController<2, DualAdvancedRunner, RunnerBlocker> static_game(runner, blocker);
+    int static_winner = static_game.RunGame();
+
+    if (static_winner != dynamic_winner ||
+        static_game.GetFitness(0) != dynamic_game.GetFitness(0) ||
+        static_game.GetFitness(1) != dynamic_game.GetFitness(1)) {
+      if (mismatches++ == 0) {
+        first_mismatch = game;
+      }
+    }
+  }
+
+  output << "static game controller: " << mismatches << " of " << games
+         << " games differ from GameController";
+  if (mismatches > 0) {
+    output << ", first seed " << 1234 + first_mismatch << " -- NOT CONFORMING";
+  }
+  output << std::endl;
+  return mismatches == 0;
+}
+
+static std::string ReplayPath() {
+  return (std::filesystem::temp_directory_path() / "bench_replay.bin").string();
+}
+
+/* One game of engine.run_game on the current seed, written to recorder if given. */
+static int PlayGame(NeuralNetwork& simple, NeuralNetwork& advanced, ReplayRecorder* recorder) {
+  DualSimpleRunner c1(simple);
+  DualAdvancedRunner c2(advanced);
+  GameController game;
+  game.AddPlayer(c1);
+  game.AddPlayer(c2);
+  if (recorder != nullptr && recorder->Open(ReplayPath())) {
+    game.SetRecorder(recorder);
+  }
+  return game.RunGame();
+}
+
+/* Recording must cost under 5% of playing. The suite's best-of rates drift by more than that
+ * between benchmarks, so each map is played and recorded back to back and the fastest of each
+ * counts. */
+static bool CheckRecordingBudget(unsigned int passes, std::ostream& output) {
+  typedef std::chrono::steady_clock Clock;
+  static double constexpr kBudget = 0.05;
+  static unsigned int constexpr kMaps = 8;
+  NeuralNetwork simple(simple_runner);
+  NeuralNetwork advanced(advanced_runner);
+  ReplayRecorder recorder;
+  std::vector<double> plain(kMaps, 0.0);
+  std::vector<double> recorded(kMaps, 0.0);
+  for (unsigned int pass = 0; pass < passes; ++pass) {
+    for (unsigned int map = 0; map < kMaps; ++map) {
+      /* Alternating which goes first, so neither always plays the map warm. */
+      for (unsigned int order = 0; order < 2; ++order) {
+        bool recording = (pass + order) % 2 == 1;
+        std::srand(1234 + map);
+        Clock::time_point start = Clock::now();
+        KeepAlive(PlayGame(simple, advanced, recording ? &recorder : nullptr));
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        double& best = recording ? recorded[map] : plain[map];
+        if (pass == 0 || seconds < best) {
+          best = seconds;
+        }
+      }
+    }
+  }
+  std::filesystem::remove(ReplayPath());
+
+  double overhead = std::accumulate(recorded.begin(), recorded.end(), 0.0) /
+                        std::accumulate(plain.begin(), plain.end(), 0.0) -
+                    1.0;
+  bool passed = overhead <= kBudget;
+  std::ios_base::fmtflags flags = output.flags();
+  std::streamsize precision = output.precision();
+  output << "recording: " << std::fixed << std::setprecision(1) << 100 * overhead
+         << "% slower than playing, best of " << passes << " (budget " << 100 * kBudget << "%)"
+         << (passed ? "" : " -- OVER BUDGET") << std::endl;
+  output.flags(flags);
+  output.precision(precision);
+  return passed;
+}
+
+static void AddGameBenchmarks(BenchmarkSuite& suite) {
+  suite.Add("engine.run_game", "games", []() {
+    static unsigned int constexpr kGames = 8;
+    NeuralNetwork simple(simple_runner);
+    NeuralNetwork advanced(advanced_runner);
+    /* The same maps every batch, so repetitions are comparable. */
+    std::srand(1234);
+    for (unsigned int i = 0; i < kGames; ++i) {
+      DualSimpleRunner c1(simple);
+      DualAdvancedRunner c2(advanced);
+      GameController game;
+      game.AddPlayer(c1);
+      game.AddPlayer(c2);
+      int winner = game.RunGame();
+      KeepAlive(winner);
+      GameController::latency_report().Merge("simple_runner", game.player(0).setup_latency(),
+                                             game.player(0).turn_latency());
+      GameController::latency_report().Merge("advanced_runner", game.player(1).setup_latency(),
+                                             game.player(1).turn_latency());
+    }
+    return kGames;
+  });
+
+  /* engine.run_game written to a replay file; CheckRecordingBudget holds the difference to 5%. */
+  suite.Add("engine.run_game_recorded", "games", []() {
+    static unsigned int constexpr kGames = 8;
+    NeuralNetwork simple(simple_runner);
+    NeuralNetwork advanced(advanced_runner);
+    std::srand(1234);
+    ReplayRecorder recorder;
+    for (unsigned int i = 0; i < kGames; ++i) {
+      KeepAlive(PlayGame(simple, advanced, &recorder));
+    }
+    return kGames;
+  });
+
+  suite.Add("engine.run_game_static", "games", []() {
+    static unsigned int constexpr kGames = 8;
+    NeuralNetwork simple(simple_runner);
+    NeuralNetwork advanced(advanced_runner);
+    std::srand(1234);
+    for (unsigned int i = 0; i < kGames; ++i) {
+      DualSimpleRunner c1(simple);
+      DualAdvancedRunner c2(advanced);
+      StaticGameController<2, DualSimpleRunner, DualAdvancedRunner> game(c1, c2);
+      int winner = game.RunGame();
+      KeepAlive(winner);
+    }
+    return kGames;
+  });
+
+  /* Every stop rule on, with one heuristic stop in four played out for the report. */
+  suite.Add("engine.run_game_terminated", "games", []() {
+    static unsigned int constexpr kGames = 8;
+    TerminationPolicy policy;
+    policy.proven = true;
+    policy.lead_checkpoints = 3;
+    policy.stall_turns = 20;
+    policy.audit_interval = 4;
+    NeuralNetwork simple(simple_runner);
+    NeuralNetwork advanced(advanced_runner);
+    std::srand(1234);
+    DualSimpleRunner c1(simple);
+    DualAdvancedRunner c2(advanced);
+    GameController game;
+    game.SetTermination(policy);
+    game.AddPlayer(c1);
+    game.AddPlayer(c2);
+    for (unsigned int i = 0; i < kGames; ++i) {
+      game.Reset();
+      int winner = game.RunGame();
+      KeepAlive(winner);
+    }
+    return kGames;
+  });
+
+  /* The trainer's first generations, where untrained networks stall and proven stops end the
+   * game. */
+  suite.Add("engine.run_game_untrained", "games", []() {
+    static unsigned int constexpr kGames = 8;
+    TerminationPolicy policy;
+    policy.proven = true;
+    NeuralNetwork simple(simple_runner);
+    std::srand(1234);
+    for (unsigned int i = 0; i < kGames; ++i) {
+      NeuralNetwork untrained(advanced_runner);
+      std::vector<double> weights = NeuralNetworkFactory::Flatten(untrained);
+      for (double& weight : weights) {
+        weight = Uniform(-1.0, 1.0);
+      }
+      NeuralNetworkFactory::Unflatten(untrained, weights);
+      DualSimpleRunner c1(simple);
+      DualAdvancedRunner c2(untrained);
+      GameController game;
+      game.SetTermination(policy);
+      game.AddPlayer(c1);
+      game.AddPlayer(c2);
+      int winner = game.RunGame();
+      KeepAlive(winner);
+    }
+    return kGames;
+  });
+
+  suite.Add("controller.search", "rollouts", []() {
+    NeuralNetwork advanced(advanced_runner);
+    /* A rollout cap instead of a clock, so every batch does the same work. */
+    SearchRunner::Config config;
+    config.budget_ms = 1e9;
+    config.first_turn_budget_ms = 1e9;
+    config.max_rollouts = 200;
+    std::srand(1234);
+    SearchRunner c1(config);
+    DualAdvancedRunner c2(advanced);
+    GameController game;
+    game.AddPlayer(c1);
+    game.AddPlayer(c2);
+    int winner = game.RunGame();
+    KeepAlive(winner);
+    return c1.rollouts();
+  });
+}
+
+/* Games against this same executable run with --bot, through a pool that either resets its
+ * processes or replaces them after every game. */
+static void AddExternalBotBenchmarks(BenchmarkSuite& suite, std::string const& executable) {
+  for (bool reset : {true, false}) {
+    BotPool::Config config;
+    config.command = executable + " --bot";
+    config.reset_command = reset ? "RESET" : "";
+    /* Generous limits: a late turn would change the game and so the work measured. */
+    config.first_turn_timeout_ms = 10000;
+    config.turn_timeout_ms = 10000;
+    /* Started on first use, so that filtered out benchmarks start no processes. */
+    auto pool = std::make_shared<std::unique_ptr<BotPool>>();
+    suite.Add(reset ? "controller.external_bot" : "controller.external_bot_respawn", "games",
+              [config, pool]() {
+                static unsigned int constexpr kGames = 4;
+                if (!*pool) {
+                  *pool = std::make_unique<BotPool>(config);
+                }
+                NeuralNetwork advanced(advanced_runner);
+                std::srand(1234);
+                ExternalBot c1(**pool);
+                DualAdvancedRunner c2(advanced);
+                GameController game;
+                game.AddPlayer(c1);
+                game.AddPlayer(c2);
+                for (unsigned int i = 0; i < kGames; ++i) {
+                  game.Reset();
+                  int winner = game.RunGame();
+                  KeepAlive(winner);
+                }
+                return kGames;
+              });
+  }
+}
+
+static void AddNetworkBenchmarks(BenchmarkSuite& suite) {
+  auto network = std::make_shared<NeuralNetwork>(advanced_runner);
+  auto inputs = std::make_shared<std::vector<NeuralNetwork::Activations>>();
+  for (unsigned int i = 0; i < 256; ++i) {
+    inputs->push_back(NeuralNetwork::Activations(DualAdvancedRunner::kInputCount));
+    for (auto& value : inputs->back()) {
+      value = Uniform(-1, 1);
+    }
+  }
+  suite.Add("network.set_input", "inferences", [network, inputs]() {
+    for (auto const& input : *inputs) {
+      network->SetInput(input);
+      KeepAlive(network->GetOutput());
+    }
+    return inputs->size();
+  });
+
+  suite.Add("network.save", "saves", [network]() {
+    std::string saved = network->Save();
+    KeepAlive(saved);
+    return 1ul;
+  });
+
+  auto saved = std::make_shared<std::string>(network->Save());
+  suite.Add("network.load", "loads", [saved]() {
+    NeuralNetwork loaded(*saved);
+    KeepAlive(loaded);
+    return 1ul;
+  });
+}
+
+static void AddGeneticBenchmarks(BenchmarkSuite& suite) {
+  suite.Add(
+      "genetics.generation", "generations",
+      []() {
+        static unsigned int constexpr kPopulation = 40;
+        BlockerFactory factory;
+        std::srand(1234);
+        GeneticAlgorithm<RunnerBlocker::Config> ga(factory, kPopulation);
+
+        /* Generation reports on stdout, which may be carrying the JSON. */
+        std::ostringstream discard;
+        std::streambuf* previous = std::cout.rdbuf(discard.rdbuf());
+        ga.Generation(0);
+        std::cout.rdbuf(previous);
+        return 1ul;
+      },
+      0);
+}
+
+/* Plays DualAdvancedRunner over stdin and stdout, as a CodinGame bot would, for the external bot
+ * benchmarks. A RESET line starts another game on the same process. */
+static int ServeBot() {
+  NeuralNetwork network(advanced_runner);
+  DualAdvancedRunner bot(network);
+  bot.SetStreams(std::cin, std::cout);
+  bot.Setup();
+  while (std::cin.peek() != EOF) {
+    if (std::cin.peek() == 'R') {
+      protocol::ReadLine(std::cin);
+      bot.Reset();
+      bot.Setup();
+    } else {
+      bot.Turn();
+    }
+  }
+  return 0;
+}
+
+/* Recording a game to a replay may cost at most 5% of playing it. Skipped unless both
+ * benchmarks ran. */
+// usage: bench.exe [--filter text] [--repetitions n] [--min-seconds s] [--output file.json]
+//                  [--compare baseline.json] [--threshold fraction] [--precision-games n]
+//                  [--conformance-cases n] [--static-games n] [--recording-passes n]
+// JSON goes to --output, or stdout if not given. With --compare, exits 1 on a regression; always
+// exits 1 if the fast math approximations are out of bounds or an engine breaks the reference
+// rules, StaticGameController plays another game than GameController or recording a game costs
+// more than 5% of playing it. --precision-games sets how many games compare float with double
+// physics, --conformance-cases how many fuzzed states the engines play against the reference, and
+// --static-games how many games StaticGameController replays and --recording-passes how often
+// each map is timed with and without a recorder (0 = skip).
+//        bench.exe --bot
+// plays one side of a game over stdin and stdout instead; the external bot benchmarks run this.
+int main(int argc, char** argv) {
+  if (argc > 1 && std::string(argv[1]) == "--bot") {
+    return ServeBot();
+  }
+
+  BenchmarkSuite::Options options;
+  std::string output_path;
+  std::string baseline_path;
+  double threshold = 0.05;
+  unsigned int precision_games = 200;
+  unsigned int conformance_cases = 2000;
+  unsigned int static_games = 200;
+  unsigned int recording_passes = 100;
+
+  for (int i = 1; i + 1 < argc; i += 2) {
+    std::string flag = argv[i];
+    std::string value = argv[i + 1];
+    if (flag == "--filter") {
+      options.filter = value;
+    } else if (flag == "--repetitions") {
+      options.repetitions = std::stoul(value);
+    } else if (flag == "--min-seconds") {
+      options.min_seconds = std::stod(value);
+    } else if (flag == "--output") {
+      output_path = value;
+    } else if (flag == "--compare") {
+      baseline_path = value;
+    } else if (flag == "--threshold") {
+      threshold = std::stod(value);
+    } else if (flag == "--precision-games") {
+      precision_games = std::stoul(value);
+    } else if (flag == "--conformance-cases") {
+      conformance_cases = std::stoul(value);
+    } else if (flag == "--static-games") {
+      static_games = std::stoul(value);
+    } else if (flag == "--recording-passes") {
+      recording_passes = std::stoul(value);
+    } else {
+      std::cerr << "unknown option " << flag << std::endl;
+      return 2;
+    }
+  }
+
+  std::srand(42);
+  BenchmarkSuite suite;
+  AddCollisionBenchmarks(suite);
+  AddForwardModelBenchmarks(suite);
+  AddMathBenchmarks(suite);
+  AddGameBenchmarks(suite);
+  AddExternalBotBenchmarks(suite, argv[0]);
+  AddNetworkBenchmarks(suite);
+  AddGeneticBenchmarks(suite);
+
+  bool accurate = CheckMathAccuracy(std::cerr);
+  if (recording_passes > 0) {
+    accurate = CheckRecordingBudget(recording_passes, std::cerr) && accurate;
+  }
+  if (precision_games > 0) {
+    ComparePrecision(precision_games, 1234).Print(std::cerr);
+  }
+  if (conformance_cases > 0) {
+    ConformanceReport conformance = CheckConformance(conformance_cases, 40, 1234);
+    conformance.Print(std::cerr);
+    accurate = accurate && conformance.passed();
+  }
+  if (static_games > 0) {
+    accurate = CheckStaticGames(static_games, std::cerr) && accurate;
+  }
+  std::vector<BenchmarkResult> results = suite.Run(options, std::cerr);
+  /* Over every game the benchmarks played; only engine.run_game_terminated and
+   * engine.run_game_untrained stop early. */
+  GameController::termination_report().Print(std::cerr);
+  /* Controllers as engine.run_game and genetics.generation timed them. */
+  GameController::latency_report().Print(std::cerr);
+  if (output_path.empty()) {
+    BenchmarkSuite::WriteJson(results, std::cout);
+  } else {
+    std::ofstream output(output_path);
+    BenchmarkSuite::WriteJson(results, output);
+  }
+
+  if (!baseline_path.empty()) {
+    std::ifstream baseline(baseline_path);
+    if (!baseline) {
+      std::cerr << "cannot read " << baseline_path << std::endl;
+      return 2;
+    }
+    bool passed = BenchmarkSuite::Compare(results, BenchmarkSuite::ReadJson(baseline), threshold,
+                                          std::cerr);
+    return passed && accurate ? 0 : 1;
+  }
+  return accurate ? 0 : 1;
+}
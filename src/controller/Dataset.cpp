@@ -0,0 +1,192 @@
+#include "Dataset.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include "Replay.hpp"
+#include "TextProtocol.hpp"
+
+using namespace dataset;
+
+bool DatasetWriter::Open(std::string const& path) {
+  Close();
+  file_ = std::fopen(path.c_str(), "wb");
+  if (!file_) {
+    return false;
+  }
+
+  /* Placeholder, rewritten by Close() once the record count is known. */
+  Header header = {kMagic, kVersion, 0, kBlockRecords, kFeatures, sizeof(State), sizeof(Action)};
+  std::fwrite(&header, sizeof(header), 1, file_);
+
+  while (free_.size() + full_.size() < kBlocks) {
+    free_.push_back(std::make_unique<Block>());
+  }
+  records_ = 0;
+  closing_ = false;
+  thread_ = std::thread(&DatasetWriter::WriteLoop, this);
+  return true;
+}
+
+void DatasetWriter::Add(State const& state, Features const& features, Action const& action) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (!file_) {
+    return;
+  }
+  if (!filling_) {
+    free_ready_.wait(lock, [this]() { return !free_.empty(); });
+    filling_ = std::move(free_.back());
+    free_.pop_back();
+    /* Zeroed so that padding, and the unused tail of a last block, is written as zeros. */
+    std::memset(filling_.get(), 0, sizeof(Block));
+    filled_ = 0;
+  }
+
+  filling_->states[filled_] = state;
+  filling_->features[filled_] = features;
+  filling_->actions[filled_] = action;
+  records_++;
+  if (++filled_ == kBlockRecords) {
+    full_.push_back(std::move(filling_));
+    full_ready_.notify_one();
+  }
+}
+
+void DatasetWriter::Close() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!file_) {
+      return;
+    }
+    if (filling_) {
+      full_.push_back(std::move(filling_));
+    }
+    closing_ = true;
+  }
+  full_ready_.notify_one();
+  thread_.join();
+
+  Header header = {kMagic, kVersion, records_, kBlockRecords, kFeatures, sizeof(State),
+                   sizeof(Action)};
+  std::fseek(file_, 0, SEEK_SET);
+  std::fwrite(&header, sizeof(header), 1, file_);
+  std::fclose(file_);
+  file_ = nullptr;
+}
+
+void DatasetWriter::WriteLoop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    full_ready_.wait(lock, [this]() { return closing_ || !full_.empty(); });
+    if (full_.empty()) {
+      return;
+    }
+    std::unique_ptr<Block> block = std::move(full_.front());
+    full_.pop_front();
+
+    lock.unlock();
+    std::fwrite(block.get(), sizeof(Block), 1, file_);
+    lock.lock();
+
+    free_.push_back(std::move(block));
+    free_ready_.notify_one();
+  }
+}
+
+DatasetRecorder::DatasetRecorder(IPlayer& controller, DatasetWriter& writer, uint8_t source)
+    : controller_(controller), writer_(writer), source_(source) {
+  controller_.SetStreams(controller_input_, controller_output_);
+}
+
+void DatasetRecorder::Setup() {
+  std::string map = ReadAll();
+  controller_input_.clear();
+  controller_input_.str(map);
+  ReadMapData(controller_input_, map_data_);
+  controller_input_.clear();
+  controller_input_.str(map);
+  controller_.Setup();
+
+  episode_ = writer_.NextEpisode();
+  turn_ = 0;
+  resumed_ = false;
+}
+
+void DatasetRecorder::Resume(RaceProgress const& progress) {
+  controller_.Resume(progress);
+  resumed_ = true;
+}
+
+/* The controller sees exactly the referee's input and the referee exactly its output; the
+ * recorder only reads both on the way through. */
+void DatasetRecorder::Turn() {
+  std::string input = ReadAll();
+  controller_input_.clear();
+  controller_input_.str(input);
+  controller_output_.str("");
+  controller_output_.clear();
+  controller_.Turn();
+  std::string const commands = controller_output_.str();
+  output_->write(commands.data(), commands.size());
+  output_->flush();
+
+  std::istringstream pods_input(input);
+  PodData pods[kPods];
+  for (unsigned int i = 0; i < kPods; ++i) {
+    pods[i] = PodData(pods_input, i % 2, i < 2 ? Owner::Me : Owner::Opponent);
+  }
+
+  State state = {};
+  state.episode = episode_;
+  state.turn = std::min(turn_, 65535u);
+  state.source = source_;
+  state.checkpoint_count = std::min<size_t>(map_data_->checkpoints.size(), kMaxCheckpoints);
+  for (unsigned int i = 0; i < state.checkpoint_count; ++i) {
+    state.checkpoints[i][0] = map_data_->checkpoints[i].first;
+    state.checkpoints[i][1] = map_data_->checkpoints[i].second;
+  }
+  for (unsigned int i = 0; i < kPods; ++i) {
+    PodData const& pod = pods[i];
+    state.pods[i] = {pod.x, pod.y, static_cast<int16_t>(pod.vx), static_cast<int16_t>(pod.vy),
+                     static_cast<int16_t>(pod.angle), static_cast<uint8_t>(pod.next_checkpoint_id),
+                     0};
+  }
+
+  char const* in = commands.data();
+  char const* end = in + commands.size();
+  std::string action_word;
+  for (unsigned int pod = 0; pod < 2; ++pod) {
+    state.pod = pod;
+
+    /* Opponents in protocol order rather than lead first; the runner's features read neither. */
+    DualAdvancedRunner::NetworkInput network_input;
+    DualAdvancedRunner::GetNetworkInput(network_input, *map_data_, turn_ == 0 && !resumed_,
+                                        pods[pod], pods[1 - pod], pods[2], pods[3]);
+    double const* values = reinterpret_cast<double const*>(&network_input);
+    Features features;
+    std::copy(values, values + kFeatures, features.values);
+
+    Action action = {};
+    int x, y;
+    if (protocol::ParseCommand(in, end, x, y, action_word)) {
+      action.x = x;
+      action.y = y;
+      if (action_word == "BOOST") {
+        action.action = replay::kActionBoost;
+      } else if (action_word == "SHIELD") {
+        action.action = replay::kActionShield;
+      } else {
+        action.action = std::atoi(action_word.c_str());
+      }
+    } else {
+      action.action = replay::kActionNone;
+    }
+
+    writer_.Add(state, features, action);
+  }
+  turn_++;
+}
+
+std::string DatasetRecorder::ReadAll() {
+  return std::string(std::istreambuf_iterator<char>(*input_), std::istreambuf_iterator<char>());
+}
@@ -0,0 +1,162 @@
+#ifndef DATASET_HPP
+#define DATASET_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "DualAdvancedRunner.hpp"
+#include "GameIO.hpp"
+#include "IPlayer.hpp"
+
+/* Dataset file layout, all little-endian:
+ *   Header
+ *   Block[ceil(records / kBlockRecords)]
+ * A block holds kBlockRecords decisions column by column: every State, then every Features,
+ * then every Action. The last block is zero-padded to full size, so record i's columns are at
+ * fixed offsets and the file can be memory-mapped as three strided arrays. */
+namespace dataset {
+
+static uint32_t constexpr kMagic = 0x54455344;  // "DSET"
+static uint32_t constexpr kVersion = 1;
+static unsigned int constexpr kPods = 4;
+static unsigned int constexpr kMaxCheckpoints = 8;
+static unsigned int constexpr kBlockRecords = 4096;
+static unsigned int constexpr kFeatures = DualAdvancedRunner::kInputCount;
+
+struct Header {
+  uint32_t magic;
+  uint32_t version;
+  uint64_t records;
+  uint32_t block_records;
+  uint32_t feature_count;
+  uint32_t state_size;
+  uint32_t action_size;
+};
+
+/* A pod as the protocol reports it. */
+struct PodRecord {
+  int32_t x;
+  int32_t y;
+  int16_t vx;
+  int16_t vy;
+  int16_t angle; /* degrees */
+  uint8_t next_checkpoint;
+  uint8_t reserved;
+};
+
+/* Everything the controller knew when deciding. */
+struct State {
+  uint32_t episode; /* one controller's game; its records are in turn order */
+  uint16_t turn;
+  uint8_t pod;    /* which of pods 0 and 1 the decision steers */
+  uint8_t source; /* the recorder's tag for the controller */
+  uint8_t checkpoint_count;
+  uint8_t reserved[3];
+  int16_t checkpoints[kMaxCheckpoints][2];
+  PodRecord pods[kPods]; /* the controller's own two, then the opponent's two */
+};
+
+/* DualAdvancedRunner::GetNetworkInput for the deciding pod, whatever made the decision. */
+struct Features {
+  float values[kFeatures];
+};
+
+struct Action {
+  int32_t x;
+  int32_t y;
+  int16_t action; /* thrust, or one of PodAction */
+  uint16_t reserved;
+};
+
+struct Block {
+  State states[kBlockRecords];
+  Features features[kBlockRecords];
+  Action actions[kBlockRecords];
+};
+
+static_assert(sizeof(Header) == 32, "dataset header layout changed");
+static_assert(sizeof(State) == 108, "dataset state layout changed");
+static_assert(sizeof(Action) == 12, "dataset action layout changed");
+
+}  // namespace dataset
+
+/* Streams decisions to a dataset file. Add fills a block in memory; full blocks are written by
+ * a background thread. Blocks come from a fixed pool, so a writer that falls behind makes Add
+ * wait instead of growing memory. Safe to share between threads. */
+class DatasetWriter {
+ public:
+  DatasetWriter() {}
+  DatasetWriter(DatasetWriter const&) = delete;
+  DatasetWriter& operator=(DatasetWriter const&) = delete;
+  ~DatasetWriter() { Close(); }
+
+  bool Open(std::string const& path);
+  void Add(dataset::State const& state, dataset::Features const& features,
+           dataset::Action const& action);
+  /* Writes the last block and the record count. */
+  void Close();
+
+  /* A new number for dataset::State::episode. */
+  uint32_t NextEpisode() { return episodes_++; }
+  uint64_t records() const { return records_; }
+
+ private:
+  static unsigned int constexpr kBlocks = 4;
+
+  void WriteLoop();
+
+  std::FILE* file_ = nullptr;
+  std::mutex mutex_;
+  std::condition_variable full_ready_;
+  std::condition_variable free_ready_;
+  std::vector<std::unique_ptr<dataset::Block>> free_;
+  std::deque<std::unique_ptr<dataset::Block>> full_;
+  std::unique_ptr<dataset::Block> filling_;
+  unsigned int filled_ = 0;
+  bool closing_ = false;
+  std::thread thread_;
+  std::atomic<uint64_t> records_{0};
+  std::atomic<uint32_t> episodes_{0};
+};
+
+/* Plays as controller and records each of its decisions to a DatasetWriter: the turn input it
+ * was given, the features DualAdvancedRunner would build from it, and the command it gave. */
+class DatasetRecorder : public IPlayer {
+ public:
+  DatasetRecorder(IPlayer& controller, DatasetWriter& writer, uint8_t source = 0);
+
+  void SetStreams(std::istream& input, std::ostream& output) override {
+    input_ = &input;
+    output_ = &output;
+  };
+
+  void Setup() override;
+  void Turn() override;
+  void Reset() override { controller_.Reset(); }
+  void Resume(RaceProgress const& progress) override;
+
+ private:
+  std::string ReadAll();
+
+  IPlayer& controller_;
+  DatasetWriter& writer_;
+  uint8_t source_;
+  std::istream* input_;
+  std::ostream* output_;
+  std::istringstream controller_input_;
+  std::ostringstream controller_output_;
+  std::unique_ptr<MapData> map_data_;
+  uint32_t episode_ = 0;
+  unsigned int turn_ = 0;
+  bool resumed_ = false;
+};
+
+#endif
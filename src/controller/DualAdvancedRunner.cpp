@@ -1,40 +1,44 @@
 #include "DualAdvancedRunner.hpp"
 
-void DualAdvancedRunner::GetNetworkInput(NetworkInput& input, PodData const& pod,
+void DualAdvancedRunner::GetNetworkInput(NetworkInput& input, MapData const& map,
+                                         bool first_turn, PodData const& pod,
                                          PodData const& ally, PodData const& lead,
                                          PodData const& trail) {
   std::vector<PodData const*> op = {&lead, &trail};
-  GetPodInput(input.pod, pod, ally, op);
+  GetPodInput(input.pod, map, first_turn, pod, ally, op);
 }
 
-void DualAdvancedRunner::GetPodInput(InputPod& input, PodData const& pod, PodData const& ally,
+void DualAdvancedRunner::GetPodInput(InputPod& input, MapData const& map, bool first_turn,
+                                     PodData const& pod, PodData const& ally,
                                      std::vector<PodData const*> const& op) {
-  GetNextCheckpoints(input.next_checkpoints, pod, pod);
-  GetVelocity(input.velocity, pod, Vec2(0, 0), PodAngle(pod));
-  // GetOtherPod(input.ally_pod, pod, ally);
-  // GetOtherPod(input.leading_enemy_pod, pod, *op.at(0));
-  // GetOtherPod(input.trailing_enemy_pod, pod, *op.at(1));
+  double angle = PodAngle(map, pod, first_turn);
+  GetNextCheckpoints(input.next_checkpoints, map, pod, angle, pod);
+  GetVelocity(input.velocity, pod, Vec2(0, 0), angle);
+  // GetOtherPod(input.ally_pod, pod, angle, ally);
+  // GetOtherPod(input.leading_enemy_pod, pod, angle, *op.at(0));
+  // GetOtherPod(input.trailing_enemy_pod, pod, angle, *op.at(1));
 }
 
-void DualAdvancedRunner::GetNextCheckpoints(InputCheckpoint* checkpoints, PodData const& from,
+void DualAdvancedRunner::GetNextCheckpoints(InputCheckpoint* checkpoints, MapData const& map,
+                                            PodData const& from, double from_angle,
                                             PodData const& perspective) {
   for (unsigned int i = 0; i < kNextCheckpoints; ++i) {
     unsigned int index = perspective.next_checkpoint_id + i;
-    index %= map_data_->checkpoints.size();
-    Vec2 next(map_data_->checkpoints[index].first, map_data_->checkpoints[index].second);
-    GetNextCheckpoint(checkpoints[i], next, from);
+    index %= map.checkpoints.size();
+    Vec2 next(map.checkpoints[index].first, map.checkpoints[index].second);
+    GetNextCheckpoint(checkpoints[i], next, from, from_angle);
   }
 }
 
 void DualAdvancedRunner::GetNextCheckpoint(InputCheckpoint& checkpoint, Vec2 const& next,
-                                           PodData const& from) {
+                                           PodData const& from, double from_angle) {
   /* next checkpoint distance */
   Vec2 position(from.x, from.y);
   Vec2 dp = next - position;
   checkpoint.distance = Vec2::Cap(dp.Length() / kMaxDistance, 1.0);
 
   /* next checkpoint left/right angles */
-  checkpoint.direction = NormalizeAngle(dp.Degrees() - PodAngle(from));
+  checkpoint.direction = NormalizeAngle(dp.Degrees() - from_angle);
 }
 
 void DualAdvancedRunner::GetVelocity(InputVelocity& velocity, PodData const& of,
@@ -45,11 +49,12 @@ void DualAdvancedRunner::GetVelocity(InputVelocity& velocity, PodData const& of,
 }
 
 void DualAdvancedRunner::GetOtherPod(InputOtherPod& output, PodData const& perspective,
-                                     PodData const& other) {
-  GetNextCheckpoint(output.relative_position, Vec2(other.x, other.y), perspective);
+                                     double perspective_angle, PodData const& other) {
+  GetNextCheckpoint(output.relative_position, Vec2(other.x, other.y), perspective,
+                    perspective_angle);
   GetVelocity(output.relative_velocity, other, Vec2(perspective.vx, perspective.vy),
-              PodAngle(perspective));
-  // GetNextCheckpoints(output.next_checkpoints, other, perspective);
+              perspective_angle);
+  // GetNextCheckpoints(output.next_checkpoints, map, other, perspective_angle, perspective);
 }
 
 void DualAdvancedRunner::WriteNetworkOutput(NetworkOutput const& output, PodData const* pod) {
@@ -74,12 +79,12 @@ void DualAdvancedRunner::WritePodOutput(OutputPod const& output, PodData const&
     action = std::to_string(thrust);
   }
 
-  double pod_angle = PodAngle(pod);
+  double pod_angle = PodAngle(*map_data_, pod, first_turn_latch_);
   double right_turn = Vec2::Cap(output.direction * 20, 40.0) / 2;
 
   double new_pod_angle = pod_angle + right_turn;
   double rad_angle = new_pod_angle * Vec2::pi() / 180;
-  Vec2 new_direction(std::cos(rad_angle), std::sin(rad_angle));
+  Vec2 new_direction(fastmath::Cos(rad_angle), fastmath::Sin(rad_angle));
   new_direction *= kMaxDistance;
   int x, y;
   x = static_cast<int>(new_direction.x());
@@ -98,14 +103,14 @@ double DualAdvancedRunner::NormalizeAngle(double angle) {
   return angle / 180;
 }
 
-double DualAdvancedRunner::PodAngle(PodData const& pod) {
+double DualAdvancedRunner::PodAngle(MapData const& map, PodData const& pod, bool first_turn) {
   double pod_angle = pod.angle;
-  if (first_turn_latch_) {
+  if (first_turn) {
     /* On the first turn the game always tells us we are pointing at 0,
        then actually lets us do an instant rotation to the first angle we request.
        We replace the angle provided by the game with the angle to the first checkpoint
        on the first turn. */
-    auto const& next_checkpoint = map_data_->checkpoints[pod.next_checkpoint_id];
+    auto const& next_checkpoint = map.checkpoints[pod.next_checkpoint_id];
     Vec2 next_cp(next_checkpoint.first, next_checkpoint.second);
     Vec2 position(pod.x, pod.y);
     Vec2 dp = next_cp - position;
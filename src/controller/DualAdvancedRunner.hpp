@@ -62,7 +62,24 @@ class DualAdvancedRunner : public IPlayer {
     output_ = &output;
   };
 
-  void Setup() override { map_data_ = std::make_unique<MapData>(*input_); }
+  void Setup() override { ReadMapData(*input_, map_data_); }
+
+  void Reset() override {
+    boosts_left_ = 1;
+    first_turn_latch_ = true;
+    for (PodTracker& pod : pods_) {
+      pod = PodTracker();
+    }
+  }
+
+  void Resume(RaceProgress const& progress) override {
+    boosts_left_ = progress.boosts_available;
+    first_turn_latch_ = false;
+    for (unsigned int i = 0; i < 4; ++i) {
+      pods_[i].laps = progress.laps[i];
+      pods_[i].last_checkpoint = progress.next_checkpoints[i];
+    }
+  }
 
   void Turn() override {
     ReadInput();
@@ -74,14 +91,16 @@ class DualAdvancedRunner : public IPlayer {
 
     NeuralNetwork::Activations in(kInputCount);
     NetworkInput* input = reinterpret_cast<NetworkInput*>(in.data());
-    GetNetworkInput(*input, pods_[0].input, pods_[1].input, op_lead.input, op_trail.input);
+    GetNetworkInput(*input, *map_data_, first_turn_latch_, pods_[0].input, pods_[1].input,
+                    op_lead.input, op_trail.input);
     network_.SetInput(in);
     NeuralNetwork::Activations const* out0 = &network_.GetOutput();
     NetworkOutput const* output = reinterpret_cast<NetworkOutput const*>(out0->data());
     WriteNetworkOutput(*output, &me[0]->input);
 
     input = reinterpret_cast<NetworkInput*>(in.data());
-    GetNetworkInput(*input, pods_[1].input, pods_[0].input, op_lead.input, op_trail.input);
+    GetNetworkInput(*input, *map_data_, first_turn_latch_, pods_[1].input, pods_[0].input,
+                    op_lead.input, op_trail.input);
     network_.SetInput(in);
     out0 = &network_.GetOutput();
     output = reinterpret_cast<NetworkOutput const*>(out0->data());
@@ -90,6 +109,12 @@ class DualAdvancedRunner : public IPlayer {
     EndInput();
   }
 
+  /* The network's input for pod, teamed with ally and racing lead and trail, on map. Static so
+   * that the same features can be built for decisions any controller makes. */
+  static void GetNetworkInput(NetworkInput& input, MapData const& map, bool first_turn,
+                              PodData const& pod, PodData const& ally, PodData const& lead,
+                              PodData const& trail);
+
  private:
   void ReadInput() {
     pods_[0].input = PodData(*input_, 0, Owner::Me);
@@ -114,25 +139,27 @@ class DualAdvancedRunner : public IPlayer {
   static double constexpr kMaxDistance = 16000.0;
   static double constexpr kMaxSpeed = 1300.0;
 
-  void GetNetworkInput(NetworkInput& input, PodData const& pod, PodData const& ally,
-                       PodData const& lead, PodData const& trail);
-  void GetPodInput(InputPod& input, PodData const& pod, PodData const& ally,
-                   std::vector<PodData const*> const& op);
+  static void GetPodInput(InputPod& input, MapData const& map, bool first_turn,
+                          PodData const& pod, PodData const& ally,
+                          std::vector<PodData const*> const& op);
 
   static double constexpr kAbilityThresh = 0.0;
   void WriteNetworkOutput(NetworkOutput const& output, PodData const* pod);
   void WritePodOutput(OutputPod const& output, PodData const& pod);
 
   static double NormalizeAngle(double angle);
-  double PodAngle(PodData const& pod);
-
-  void GetNextCheckpoints(InputCheckpoint* checkpoints, PodData const& from,
-                          PodData const& perspective);
-
-  void GetNextCheckpoint(InputCheckpoint& checkpoint, Vec2 const& next, PodData const& from);
-  void GetVelocity(InputVelocity& velocity, PodData const& of, Vec2 const& ref_velocity,
-                   double ref_angle);
-  void GetOtherPod(InputOtherPod& output, PodData const& perspective, PodData const& other);
+  static double PodAngle(MapData const& map, PodData const& pod, bool first_turn);
+
+  static void GetNextCheckpoints(InputCheckpoint* checkpoints, MapData const& map,
+                                 PodData const& from, double from_angle,
+                                 PodData const& perspective);
+
+  static void GetNextCheckpoint(InputCheckpoint& checkpoint, Vec2 const& next,
+                                PodData const& from, double from_angle);
+  static void GetVelocity(InputVelocity& velocity, PodData const& of, Vec2 const& ref_velocity,
+                          double ref_angle);
+  static void GetOtherPod(InputOtherPod& output, PodData const& perspective,
+                          double perspective_angle, PodData const& other);
   unsigned int GetLeadPod(std::vector<PodTracker const*> pods);
 
   int boosts_left_;
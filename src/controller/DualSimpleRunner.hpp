@@ -38,7 +38,17 @@ class DualSimpleRunner : public IPlayer {
     output_ = &output;
   };
 
-  void Setup() override { map_data_ = std::make_unique<MapData>(*input_); }
+  void Setup() override { ReadMapData(*input_, map_data_); }
+
+  void Reset() override {
+    boosts_left_ = 1;
+    first_turn_latch_ = true;
+  }
+
+  void Resume(RaceProgress const& progress) override {
+    boosts_left_ = progress.boosts_available;
+    first_turn_latch_ = false;
+  }
 
   void Turn() override {
     PodData me1(*input_, 1, Owner::Me);
@@ -139,7 +149,7 @@ class DualSimpleRunner : public IPlayer {
     }
     double new_pod_angle = pod_angle + right_turn;
     double rad_angle = new_pod_angle * Vec2::pi() / 180;
-    Vec2 new_direction(std::cos(rad_angle), std::sin(rad_angle));
+    Vec2 new_direction(fastmath::Cos(rad_angle), fastmath::Sin(rad_angle));
     new_direction *= kMaxDistance;
     int x, y;
     x = static_cast<int>(new_direction.x());
@@ -6,9 +6,8 @@
 #include <memory>
 #include <string>
 #include <vector>
+#include "GameIO.hpp"
 #include "IPlayer.hpp"
-#include "input.hpp"
-#include "output.hpp"
 
 class DumbController : public IPlayer {
  public:
@@ -19,7 +18,9 @@ class DumbController : public IPlayer {
     output_ = &output;
   };
 
-  void Setup() override { map_data_ = std::make_unique<MapData>(*input_); }
+  void Setup() override { ReadMapData(*input_, map_data_); }
+  void Reset() override { boosts_left_ = 1; }
+  void Resume(RaceProgress const& progress) override { boosts_left_ = progress.boosts_available; }
 
   void Turn() override {
     PodData me1(*input_, 1, Owner::Me);
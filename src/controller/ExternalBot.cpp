@@ -0,0 +1,360 @@
+#include "ExternalBot.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <iterator>
+#include <sstream>
+#include <utility>
+#include "FastMath.hpp"
+#include "GameIO.hpp"
+#include "Vec2.hpp"
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+BotProcess::BotProcess(std::string const& command, bool forward_stderr) {
+  SECURITY_ATTRIBUTES security = {sizeof(SECURITY_ATTRIBUTES), nullptr, TRUE};
+  HANDLE child_stdin = nullptr;
+  HANDLE child_stdout = nullptr;
+  HANDLE parent_stdin = nullptr;
+  HANDLE parent_stdout = nullptr;
+  if (!CreatePipe(&child_stdin, &parent_stdin, &security, 0)) {
+    return;
+  }
+  if (!CreatePipe(&parent_stdout, &child_stdout, &security, 0)) {
+    CloseHandle(child_stdin);
+    CloseHandle(parent_stdin);
+    return;
+  }
+  /* Only the child's ends are inherited. */
+  SetHandleInformation(parent_stdin, HANDLE_FLAG_INHERIT, 0);
+  SetHandleInformation(parent_stdout, HANDLE_FLAG_INHERIT, 0);
+
+  HANDLE child_stderr = forward_stderr
+                            ? GetStdHandle(STD_ERROR_HANDLE)
+                            : CreateFileA("NUL", GENERIC_WRITE, FILE_SHARE_WRITE, &security,
+                                          OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  STARTUPINFOA startup = {};
+  startup.cb = sizeof(startup);
+  startup.dwFlags = STARTF_USESTDHANDLES;
+  startup.hStdInput = child_stdin;
+  startup.hStdOutput = child_stdout;
+  startup.hStdError = child_stderr;
+  PROCESS_INFORMATION info = {};
+  std::vector<char> command_line(command.begin(), command.end());
+  command_line.push_back('\0');
+  BOOL created = CreateProcessA(nullptr, command_line.data(), nullptr, nullptr, TRUE,
+                                CREATE_NO_WINDOW, nullptr, nullptr, &startup, &info);
+
+  CloseHandle(child_stdin);
+  CloseHandle(child_stdout);
+  if (!forward_stderr && child_stderr != INVALID_HANDLE_VALUE) {
+    CloseHandle(child_stderr);
+  }
+  if (!created) {
+    CloseHandle(parent_stdin);
+    CloseHandle(parent_stdout);
+    return;
+  }
+  CloseHandle(info.hThread);
+  process_ = info.hProcess;
+  stdin_ = parent_stdin;
+  stdout_ = parent_stdout;
+}
+
+bool BotProcess::running() const {
+  return process_ && WaitForSingleObject(process_, 0) == WAIT_TIMEOUT;
+}
+
+bool BotProcess::Write(std::string const& text) {
+  char const* data = text.data();
+  size_t left = text.size();
+  while (left > 0) {
+    DWORD written = 0;
+    if (!stdin_ || !WriteFile(stdin_, data, static_cast<DWORD>(left), &written, nullptr)) {
+      return false;
+    }
+    data += written;
+    left -= written;
+  }
+  return true;
+}
+
+/* Anonymous pipes cannot wait with a timeout, so this polls, yielding the core in between: a
+ * Sleep(1) would cost a scheduler tick of up to 15 ms per turn. */
+bool BotProcess::ReadLine(std::string& line, Clock::time_point deadline) {
+  while (!TakeLine(line)) {
+    DWORD available = 0;
+    if (!stdout_ || !PeekNamedPipe(stdout_, nullptr, 0, nullptr, &available, nullptr)) {
+      return false;
+    }
+    if (available > 0) {
+      char chunk[4096];
+      DWORD read = 0;
+      if (!ReadFile(stdout_, chunk, std::min<DWORD>(available, sizeof(chunk)), &read, nullptr)) {
+        return false;
+      }
+      buffer_.append(chunk, read);
+      continue;
+    }
+    if (Clock::now() >= deadline) {
+      return false;
+    }
+    Sleep(0);
+  }
+  return true;
+}
+
+void BotProcess::Kill() {
+  if (process_) {
+    TerminateProcess(process_, 1);
+    WaitForSingleObject(process_, INFINITE);
+    CloseHandle(process_);
+  }
+  if (stdin_) {
+    CloseHandle(stdin_);
+  }
+  if (stdout_) {
+    CloseHandle(stdout_);
+  }
+  process_ = nullptr;
+  stdin_ = nullptr;
+  stdout_ = nullptr;
+  buffer_.clear();
+}
+#else
+/* Pipe ends are close-on-exec from the start, so that bots forked from other threads meanwhile
+ * do not inherit them. */
+static bool OpenPipe(int (&ends)[2]) { return pipe2(ends, O_CLOEXEC) == 0; }
+
+BotProcess::BotProcess(std::string const& command, bool forward_stderr) {
+  /* A bot that exits mid-game makes Write fail instead of killing us. */
+  static bool const ignore_sigpipe = signal(SIGPIPE, SIG_IGN) != SIG_ERR;
+  (void)ignore_sigpipe;
+
+  int to_child[2];
+  int from_child[2];
+  if (!OpenPipe(to_child)) {
+    return;
+  }
+  if (!OpenPipe(from_child)) {
+    close(to_child[0]);
+    close(to_child[1]);
+    return;
+  }
+
+  pid_t pid = fork();
+  if (pid == 0) {
+    dup2(to_child[0], STDIN_FILENO);
+    dup2(from_child[1], STDOUT_FILENO);
+    if (!forward_stderr) {
+      int null = open("/dev/null", O_WRONLY);
+      dup2(null, STDERR_FILENO);
+    }
+    execl("/bin/sh", "sh", "-c", command.c_str(), static_cast<char*>(nullptr));
+    _exit(127);
+  }
+
+  close(to_child[0]);
+  close(from_child[1]);
+  if (pid < 0) {
+    close(to_child[1]);
+    close(from_child[0]);
+    return;
+  }
+  pid_ = pid;
+  stdin_ = to_child[1];
+  stdout_ = from_child[0];
+}
+
+/* A child found to have exited is reaped here, so its pid is forgotten before it can be reused. */
+bool BotProcess::running() const {
+  if (pid_ <= 0) {
+    return false;
+  }
+  if (waitpid(pid_, nullptr, WNOHANG) == 0) {
+    return true;
+  }
+  pid_ = -1;
+  exited_ = true;
+  return false;
+}
+
+bool BotProcess::Write(std::string const& text) {
+  char const* data = text.data();
+  size_t left = text.size();
+  while (left > 0) {
+    ssize_t written = stdin_ >= 0 ? write(stdin_, data, left) : -1;
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    data += written;
+    left -= written;
+  }
+  return true;
+}
+
+bool BotProcess::ReadLine(std::string& line, Clock::time_point deadline) {
+  while (!TakeLine(line)) {
+    auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now());
+    pollfd ready = {stdout_, POLLIN, 0};
+    int events = stdout_ >= 0 ? poll(&ready, 1, std::max<long>(left.count(), 0)) : -1;
+    if (events < 0 && errno == EINTR) {
+      continue;
+    }
+    if (events <= 0) {
+      return false;
+    }
+    char chunk[4096];
+    ssize_t read_bytes = read(stdout_, chunk, sizeof(chunk));
+    if (read_bytes <= 0) {
+      return false;
+    }
+    buffer_.append(chunk, read_bytes);
+  }
+  return true;
+}
+
+void BotProcess::Kill() {
+  if (stdin_ >= 0) {
+    close(stdin_);
+  }
+  if (stdout_ >= 0) {
+    close(stdout_);
+  }
+  if (pid_ > 0 && !exited_) {
+    kill(pid_, SIGKILL);
+    waitpid(pid_, nullptr, 0);
+  }
+  pid_ = -1;
+  stdin_ = -1;
+  stdout_ = -1;
+  buffer_.clear();
+}
+#endif
+
+bool BotProcess::TakeLine(std::string& line) {
+  size_t end = buffer_.find('\n');
+  if (end == std::string::npos) {
+    return false;
+  }
+  size_t length = end > 0 && buffer_[end - 1] == '\r' ? end - 1 : end;
+  line.assign(buffer_, 0, length);
+  buffer_.erase(0, end + 1);
+  return true;
+}
+
+BotPool::BotPool(Config const& config) : config_(config) {
+  for (unsigned int i = 0; i < config_.spares; ++i) {
+    idle_.push_back(Start());
+  }
+}
+
+std::unique_ptr<BotProcess> BotPool::Acquire() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    /* Oldest first: it has had the longest to start up. */
+    while (!idle_.empty()) {
+      std::unique_ptr<BotProcess> process = std::move(idle_.front());
+      idle_.erase(idle_.begin());
+      if (process->running()) {
+        return process;
+      }
+    }
+  }
+  return Start();
+}
+
+void BotPool::Release(std::unique_ptr<BotProcess> process, bool reusable) {
+  if (!reusable) {
+    process.reset();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (idle_.size() >= config_.spares) {
+        return;
+      }
+    }
+    process = Start();
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  idle_.push_back(std::move(process));
+}
+
+std::unique_ptr<BotProcess> BotPool::Start() {
+  started_++;
+  return std::make_unique<BotProcess>(config_.command, config_.forward_stderr);
+}
+
+/* A process still held is mid-game: it is reset, or replaced, before the new map. */
+void ExternalBot::Setup() {
+  if (process_) {
+    Reset();
+  }
+  process_ = pool_.Acquire();
+  first_turn_ = true;
+  failed_ = !process_->Write(ReadAll());
+}
+
+void ExternalBot::Turn() {
+  double timeout_ms =
+      first_turn_ ? pool_.config().first_turn_timeout_ms : pool_.config().turn_timeout_ms;
+  BotProcess::Clock::time_point deadline =
+      BotProcess::Clock::now() + std::chrono::microseconds(static_cast<long>(timeout_ms * 1000));
+  first_turn_ = false;
+
+  std::string input = ReadAll();
+  if (failed_ || !process_->Write(input)) {
+    Fail(input);
+    return;
+  }
+
+  std::string commands;
+  for (unsigned int i = 0; i < kPods; ++i) {
+    if (!process_->ReadLine(line_, deadline)) {
+      Fail(input);
+      return;
+    }
+    commands += line_;
+    commands += '\n';
+  }
+  output_->write(commands.data(), commands.size());
+}
+
+/* The process goes back for reuse only if it finished the game in step and took the reset. */
+void ExternalBot::Reset() {
+  if (!process_) {
+    return;
+  }
+  std::string const& reset = pool_.config().reset_command;
+  bool reusable = !failed_ && !reset.empty() && process_->Write(reset + "\n");
+  pool_.Release(std::move(process_), reusable);
+  failed_ = false;
+}
+
+std::string ExternalBot::ReadAll() {
+  return std::string(std::istreambuf_iterator<char>(*input_), std::istreambuf_iterator<char>());
+}
+
+/* The bot is out of step with the game for good: stop talking to it and coast, thrust 0 along
+ * each pod's heading. */
+void ExternalBot::Fail(std::string const& input) {
+  timeouts_++;
+  failed_ = true;
+  std::istringstream pods(input);
+  for (unsigned int i = 0; i < kPods; ++i) {
+    PodData pod(pods, i, Owner::Me);
+    double angle = pod.angle * Vec2::pi() / 180;
+    TakeMove(*output_, pod.x + static_cast<int>(1000 * fastmath::Cos(angle)),
+             pod.y + static_cast<int>(1000 * fastmath::Sin(angle)), "0");
+  }
+}
@@ -0,0 +1,124 @@
+#ifndef EXTERNALBOT_HPP
+#define EXTERNALBOT_HPP
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "IPlayer.hpp"
+
+/* A program running as a child process, spoken to over its stdin and stdout. */
+class BotProcess {
+ public:
+  typedef std::chrono::steady_clock Clock;
+
+  /* Runs command with /bin/sh, or as a CreateProcess command line on Windows. Check running()
+   * for success. */
+  BotProcess(std::string const& command, bool forward_stderr);
+  BotProcess(BotProcess const&) = delete;
+  BotProcess& operator=(BotProcess const&) = delete;
+  ~BotProcess() { Kill(); }
+
+  bool running() const;
+  bool Write(std::string const& text);
+  /* Next line of output without its line ending. False if the deadline passes or the process
+   * closes its output first. */
+  bool ReadLine(std::string& line, Clock::time_point deadline);
+  void Kill();
+
+ private:
+  bool TakeLine(std::string& line);
+
+  std::string buffer_; /* Output read but not yet returned. */
+#ifdef _WIN32
+  void* process_ = nullptr;
+  void* stdin_ = nullptr;
+  void* stdout_ = nullptr;
+#else
+  mutable int pid_ = -1;
+  mutable bool exited_ = false;
+  int stdin_ = -1;
+  int stdout_ = -1;
+#endif
+};
+
+/* Started processes of one bot, shared by ExternalBot players on any thread. A CodinGame bot
+ * plays one game per process, so by default a process is killed after its game and a spare,
+ * started earlier and already waiting for its map, takes its place. Bots that understand
+ * reset_command instead go back to the pool and play the next game on the same process. */
+class BotPool {
+ public:
+  struct Config {
+    std::string command;
+    /* Processes kept started ahead of the games that will need them. */
+    unsigned int spares = 2;
+    /* Line sent after a game to start another on the same process (empty = not supported). */
+    std::string reset_command;
+    /* CodinGame's limits. A late bot is cut off and idles for the rest of the game; enforce
+     * the loss with GameController::SetLatencyBudget. */
+    double first_turn_timeout_ms = 1000.0;
+    double turn_timeout_ms = 75.0;
+    /* Pass the bots' debug output through to our stderr instead of discarding it. */
+    bool forward_stderr = false;
+  };
+
+  BotPool(Config const& config);
+
+  std::unique_ptr<BotProcess> Acquire();
+  /* A process that is not reusable is killed and replaced by a new spare. */
+  void Release(std::unique_ptr<BotProcess> process, bool reusable);
+
+  Config const& config() const { return config_; }
+  unsigned long started() const { return started_; }
+
+ private:
+  std::unique_ptr<BotProcess> Start();
+
+  Config config_;
+  std::mutex mutex_;
+  std::vector<std::unique_ptr<BotProcess>> idle_;
+  std::atomic<unsigned long> started_{0};
+};
+
+/* Plays as an external bot from a BotPool: forwards the map and each turn's input to the bot's
+ * process and its commands back. A process is taken from the pool at Setup and handed back at
+ * Reset or destruction. */
+class ExternalBot : public IPlayer {
+ public:
+  ExternalBot(BotPool& pool) : pool_(pool) {}
+  ExternalBot(ExternalBot const&) = delete;
+  ExternalBot& operator=(ExternalBot const&) = delete;
+  ~ExternalBot() { Reset(); }
+
+  void SetStreams(std::istream& input, std::ostream& output) override {
+    input_ = &input;
+    output_ = &output;
+  };
+
+  void Setup() override;
+  void Turn() override;
+  void Reset() override;
+
+  /* Turns the bot missed a deadline or had exited, over every game played. */
+  unsigned long timeouts() const { return timeouts_; }
+
+ private:
+  static unsigned int constexpr kPods = 2;
+
+  std::string ReadAll();
+  void Fail(std::string const& input);
+
+  BotPool& pool_;
+  std::unique_ptr<BotProcess> process_;
+  std::istream* input_;
+  std::ostream* output_;
+  bool first_turn_ = true;
+  bool failed_ = false;
+  unsigned long timeouts_ = 0;
+  std::string line_;
+};
+
+#endif
@@ -2,8 +2,10 @@
 #define GAMEIO_HPP
 
 #include <istream>
+#include <memory>
 #include <string>
 #include <vector>
+#include "TextProtocol.hpp"
 
 enum class Owner { Me, Opponent };
 
@@ -11,7 +13,7 @@ struct PodData {
   PodData() {}
 
   PodData(std::istream& input, int id, Owner owner) : id(id), owner(owner) {
-    input >> x >> y >> vx >> vy >> angle >> next_checkpoint_id;
+    protocol::ReadInts(input, {&x, &y, &vx, &vy, &angle, &next_checkpoint_id});
   }
 
   int id;
@@ -25,15 +27,19 @@ struct PodData {
 };
 
 struct MapData {
-  MapData(std::istream& input) {
-    input >> laps;
+  MapData(std::istream& input) { Read(input); }
+
+  /* Replaces the map, keeping the checkpoint buffer. */
+  void Read(std::istream& input) {
+    protocol::ReadInts(input, {&laps});
 
     int checkpoint_count;
-    input >> checkpoint_count;
+    protocol::ReadInts(input, {&checkpoint_count});
 
-    while (checkpoint_count--) {
+    checkpoints.clear();
+    while (checkpoint_count-- > 0) {
       int x, y;
-      input >> x >> y;
+      protocol::ReadInts(input, {&x, &y});
       checkpoints.push_back(std::pair<int, int>(x, y));
     }
   }
@@ -42,12 +48,40 @@ struct MapData {
   std::vector<std::pair<int, int>> checkpoints;
 };
 
+/* Setup for controllers that may play several games: reuses the map from the last one. */
+inline void ReadMapData(std::istream& input, std::unique_ptr<MapData>& map_data) {
+  if (map_data) {
+    map_data->Read(input);
+  } else {
+    map_data = std::make_unique<MapData>(input);
+  }
+}
+
+/* "x y action", one line per pod, flushed for the referee. */
+inline void TakeMove(std::ostream& output, int x, int y, char const* action, size_t length) {
+  char buffer[2 * protocol::kMaxIntChars + 2];
+  char* end = protocol::FormatInt(buffer, x);
+  *end++ = ' ';
+  end = protocol::FormatInt(end, y);
+  *end++ = ' ';
+  output.write(buffer, end - buffer);
+  output.write(action, length);
+  output.put('\n');
+  output.flush();
+}
+
 inline void TakeMove(std::ostream& output, int x, int y, std::string const& action) {
-  output << x << " " << y << " " << action << std::endl;
+  TakeMove(output, x, y, action.data(), action.size());
+}
+
+inline void TakeMove(std::ostream& output, int x, int y, char const* action) {
+  TakeMove(output, x, y, action, std::char_traits<char>::length(action));
 }
 
 inline void TakeMove(std::ostream& output, int x, int y, double thrust) {
-  TakeMove(output, x, y, std::to_string(static_cast<int>(thrust * 100)));
+  char buffer[protocol::kMaxIntChars];
+  TakeMove(output, x, y, buffer,
+           protocol::FormatInt(buffer, static_cast<int>(thrust * 100)) - buffer);
 }
 
 inline void TakeMoveBoost(std::ostream& output, int x, int y) { TakeMove(output, x, y, "BOOST"); }
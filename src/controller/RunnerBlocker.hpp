@@ -58,7 +58,23 @@ class RunnerBlocker : public IPlayer {
     output_ = &output;
   };
 
-  void Setup() override { map_data_ = std::make_unique<MapData>(*input_); }
+  void Setup() override { ReadMapData(*input_, map_data_); }
+
+  void Reset() override {
+    first_turn_latch_ = true;
+    for (PodTracker& pod : pods_) {
+      pod = PodTracker();
+    }
+  }
+
+  void Resume(RaceProgress const& progress) override {
+    first_turn_latch_ = false;
+    for (unsigned int i = 0; i < 4; ++i) {
+      pods_[i].laps = progress.laps[i];
+      pods_[i].last_checkpoint = progress.next_checkpoints[i];
+      pods_[i].boost_left = progress.boosts_available;
+    }
+  }
 
   void Turn() override {
     ReadInput();
@@ -169,7 +185,7 @@ void RunnerBlocker::WriteNetworkOutput(NetworkOutput const& output, PodTracker&
 
   double new_pod_angle = pod_angle + right_turn;
   double rad_angle = new_pod_angle * Vec2::pi() / 180;
-  Vec2 new_direction(std::cos(rad_angle), std::sin(rad_angle));
+  Vec2 new_direction(fastmath::Cos(rad_angle), fastmath::Sin(rad_angle));
   new_direction *= kMaxDistance;
   int x, y;
   x = static_cast<int>(new_direction.x());
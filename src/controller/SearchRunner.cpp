@@ -0,0 +1,265 @@
+#include "SearchRunner.hpp"
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+/* Depth is chosen so that each extra turn of lookahead still gets this many rollouts. */
+static double constexpr kRolloutsPerDepth = 50.0;
+static double constexpr kCheckpointValue = 30000.0;
+
+void SearchRunner::Setup() {
+  ReadMapData(*input_, map_data_);
+  std::vector<Vec2> map;
+  for (auto const& checkpoint : map_data_->checkpoints) {
+    map.push_back(Vec2(checkpoint.first, checkpoint.second));
+  }
+  model_ = std::make_unique<ForwardModel>(map);
+}
+
+/* Keeps the random stream and the rollout totals; cached leaves belong to the old map. */
+void SearchRunner::Reset() {
+  for (PodTracker& pod : pods_) {
+    pod = PodTracker();
+  }
+  boosts_left_ = 1;
+  first_turn_ = true;
+  depth_ = 0;
+  best_ = Plan();
+  if (table_) {
+    table_->Clear();
+  }
+}
+
+void SearchRunner::Resume(RaceProgress const& progress) {
+  for (unsigned int i = 0; i < ForwardState::kPods; ++i) {
+    pods_[i].laps = progress.laps[i];
+    pods_[i].last_checkpoint = progress.next_checkpoints[i];
+  }
+  boosts_left_ = progress.boosts_available;
+  first_turn_ = false;
+}
+
+void SearchRunner::Turn() {
+  typedef std::chrono::steady_clock Clock;
+  Clock::time_point begin = Clock::now();
+  double budget = (first_turn_ ? config_.first_turn_budget_ms : config_.budget_ms) / 1000.0;
+
+  ReadInput();
+  ForwardState start = CurrentState();
+  depth_ = ChooseDepth();
+  if (table_) {
+    table_->NewSearch();
+  }
+
+  /* Last turn's plan, one turn on, is usually still good. */
+  std::vector<Plan> population(std::max(2u, config_.population));
+  for (unsigned int p = 0; p < population.size(); ++p) {
+    std::vector<Move>& moves = population[p].moves;
+    if (p == 0 && best_.moves.size() > 2) {
+      moves.assign(best_.moves.begin() + 2, best_.moves.end());
+    }
+    moves.resize(std::min<size_t>(moves.size(), depth_ * 2));
+    while (moves.size() < depth_ * 2) {
+      moves.push_back(RandomMove());
+    }
+    population[p].score = Evaluate(population[p], start);
+  }
+  unsigned long rollouts = population.size();
+
+  auto elapsed = [&begin]() {
+    return std::chrono::duration<double>(Clock::now() - begin).count();
+  };
+  while ((config_.max_rollouts == 0 || rollouts < config_.max_rollouts) && elapsed() < budget) {
+    auto by_score = [](Plan const& left, Plan const& right) { return left.score < right.score; };
+    auto best = std::max_element(population.begin(), population.end(), by_score);
+    auto worst = std::min_element(population.begin(), population.end(), by_score);
+
+    Plan child = Uniform() < 0.5 ? *best : population[Uniform() * population.size()];
+    Mutate(child);
+    child.score = Evaluate(child, start);
+    rollouts++;
+    if (child.score > worst->score) {
+      *worst = child;
+    }
+  }
+
+  best_ = *std::max_element(population.begin(), population.end(),
+                            [](Plan const& left, Plan const& right) {
+                              return left.score < right.score;
+                            });
+
+  for (unsigned int i = 0; i < 2; ++i) {
+    Move const& move = best_.moves[i];
+    PodControl control;
+    ToControl(move, start.pods[i], control);
+    TakeMove(*output_, control.x, control.y, control.action);
+
+    if (move.thrust == kShield) {
+      pods_[i].shield_cooldown = 3;
+    } else {
+      if (move.thrust == kBoost && pods_[i].shield_cooldown == 0 && boosts_left_ > 0) {
+        boosts_left_--;
+      }
+      pods_[i].shield_cooldown = std::max(0, pods_[i].shield_cooldown - 1);
+    }
+  }
+
+  double seconds = elapsed();
+  if (seconds > 0) {
+    steps_per_second_ = rollouts * depth_ / seconds;
+  }
+  rollouts_ += rollouts;
+  seconds_ += seconds;
+  if (config_.verbose) {
+    std::cerr << "search: depth " << depth_ << ", " << rollouts << " rollouts, "
+              << static_cast<long>(rollouts / std::max(seconds, 1e-9)) << "/s" << std::endl;
+    if (table_) {
+      table_->stats().Print(std::cerr);
+    }
+  }
+  first_turn_ = false;
+}
+
+void SearchRunner::ReadInput() {
+  for (unsigned int i = 0; i < ForwardState::kPods; ++i) {
+    PodTracker& pod = pods_[i];
+    pod.input = PodData(*input_, i % 2, i < 2 ? Owner::Me : Owner::Opponent);
+    /* The engine starts every pod on checkpoint 1 and starts a lap on reaching checkpoint 0. */
+    if (pod.input.next_checkpoint_id == 0 && pod.last_checkpoint != 0) {
+      pod.laps++;
+    }
+    pod.last_checkpoint = pod.input.next_checkpoint_id;
+  }
+}
+
+ForwardState SearchRunner::CurrentState() const {
+  ForwardState state;
+  for (unsigned int i = 0; i < ForwardState::kPods; ++i) {
+    PodData const& in = pods_[i].input;
+    double angle = in.angle * Vec2::pi() / 180;
+    PodState pod = {Vec2(in.x, in.y),
+                    Vec2(in.vx, in.vy),
+                    Vec2(fastmath::Cos(angle), fastmath::Sin(angle)),
+                    static_cast<int>(pods_[i].laps),
+                    static_cast<unsigned int>(in.next_checkpoint_id),
+                    pods_[i].shield_cooldown};
+    state.pods[i].SetState(pod);
+  }
+  state.boosts_available[0] = boosts_left_;
+  return state;
+}
+
+unsigned int SearchRunner::ChooseDepth() const {
+  double steps = config_.max_rollouts > 0
+                     ? static_cast<double>(config_.max_rollouts) * config_.max_depth
+                     : steps_per_second_ * config_.budget_ms / 1000.0;
+  unsigned int depth = std::sqrt(steps / kRolloutsPerDepth);
+  return std::max(config_.min_depth, std::min(config_.max_depth, depth));
+}
+
+double SearchRunner::Evaluate(Plan const& plan, ForwardState const& start) const {
+  ForwardState state = start;
+  for (unsigned int t = 0; t < depth_; ++t) {
+    PodControl controls[ForwardState::kPods];
+    for (unsigned int i = 0; i < 2; ++i) {
+      ToControl(plan.moves[t * 2 + i], state.pods[i], controls[i]);
+    }
+    for (unsigned int i = 2; i < ForwardState::kPods; ++i) {
+      controls[i] = model_->Predict(state.pods[i]);
+    }
+
+    int winner = model_->Step(state, controls, first_turn_ && t == 0);
+    if (winner == 0) {
+      return 1e9 - t;
+    }
+    if (winner != -1) {
+      return -1e9 + t;
+    }
+  }
+
+  return Leaf(state);
+}
+
+double SearchRunner::Leaf(ForwardState const& state) const {
+  if (!table_) {
+    return config_.leaf ? config_.leaf(*model_, state) : Heuristic(state);
+  }
+
+  uint64_t key = Zobrist::Hash(state);
+  TranspositionTable::Entry entry;
+  if (table_->Probe(key, entry)) {
+    return entry.value;
+  }
+  entry.value = config_.leaf ? config_.leaf(*model_, state) : Heuristic(state);
+  entry.move = 0;
+  entry.depth = depth_;
+  table_->Store(key, entry);
+  return entry.value;
+}
+
+double SearchRunner::Heuristic(ForwardState const& state) const {
+  double me[2] = {Progress(state.pods[0]), Progress(state.pods[1])};
+  double op = std::max(Progress(state.pods[2]), Progress(state.pods[3]));
+  return std::max(me[0], me[1]) + 0.25 * std::min(me[0], me[1]) - 0.5 * op;
+}
+
+double SearchRunner::Progress(Pod const& pod) const {
+  std::vector<Vec2> const& map = model_->map();
+  double passed = pod.lap() * static_cast<double>(map.size()) + pod.next_checkpoint() - 1;
+  return passed * kCheckpointValue - (map[pod.next_checkpoint()] - pod.position()).Length();
+}
+
+void SearchRunner::ToControl(Move const& move, Pod const& pod, PodControl& control) const {
+  Vec2 direction = pod.direction();
+  direction.Rotate(move.angle * Vec2::pi() / 180);
+  Vec2 target = pod.position() + direction * 10000;
+  control.x = static_cast<int>(target.x());
+  control.y = static_cast<int>(target.y());
+  if (move.thrust == kShield) {
+    control.action = "SHIELD";
+  } else if (move.thrust == kBoost) {
+    control.action = "BOOST";
+  } else {
+    control.action = std::to_string(move.thrust);
+  }
+}
+
+SearchRunner::Move SearchRunner::RandomMove() {
+  Move move;
+  move.angle = Uniform() * 36 - 18;
+  double r = Uniform();
+  if (r < 0.04) {
+    move.thrust = kShield;
+  } else if (r < 0.06 && boosts_left_ > 0) {
+    move.thrust = kBoost;
+  } else if (r < 0.5) {
+    move.thrust = 100;
+  } else {
+    move.thrust = Uniform() * 101;
+  }
+  return move;
+}
+
+void SearchRunner::Mutate(Plan& plan) {
+  Move& move = plan.moves[Uniform() * plan.moves.size()];
+  if (Uniform() < 0.2) {
+    move = RandomMove();
+    return;
+  }
+
+  move.angle = std::max(-18.0, std::min(18.0, move.angle + (Uniform() - 0.5) * 18));
+  if (move.thrust >= 0) {
+    int thrust = move.thrust + static_cast<int>((Uniform() - 0.5) * 60);
+    move.thrust = std::max(0, std::min(100, thrust));
+  } else {
+    move.thrust = Uniform() * 101;
+  }
+}
+
+/* xorshift64*, so the search never touches the rand() stream the engine draws maps from. */
+double SearchRunner::Uniform() {
+  random_ ^= random_ >> 12;
+  random_ ^= random_ << 25;
+  random_ ^= random_ >> 27;
+  return ((random_ * 0x2545f4914f6cdd1dull) >> 11) * (1.0 / 9007199254740992.0);
+}
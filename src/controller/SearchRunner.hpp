@@ -0,0 +1,114 @@
+#ifndef SEARCHRUNNER_HPP
+#define SEARCHRUNNER_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <vector>
+#include "ForwardModel.hpp"
+#include "GameIO.hpp"
+#include "IPlayer.hpp"
+#include "TranspositionTable.hpp"
+#include "Vec2.hpp"
+
+/* Plans both pods a few turns ahead by playing candidate command sequences through the engine's
+ * ForwardModel until the turn's time budget runs out (rolling-horizon evolution): the best plan
+ * of the previous turn seeds the population, then one mutated plan at a time replaces the worst.
+ * Opponent pods are assumed to race to their next checkpoint. */
+class SearchRunner : public IPlayer {
+ public:
+  struct Config {
+    double budget_ms = 40.0;
+    double first_turn_budget_ms = 400.0;
+    /* Stop after this many rollouts even if time is left (0 = no limit). With a limit and an
+     * unreachable budget the search is deterministic, which is what training wants. */
+    unsigned int max_rollouts = 0;
+    unsigned int min_depth = 2;
+    unsigned int max_depth = 6;
+    unsigned int population = 8;
+    uint64_t seed = 0x5eed;
+    /* Scores a leaf for player 0 (this controller); higher is better. Empty = checkpoint
+     * progress heuristic. */
+    std::function<double(ForwardModel const&, ForwardState const&)> leaf;
+    /* Size of a table caching leaf scores by state, which pays off when `leaf` is expensive
+     * (0 = no table). */
+    size_t table_mb = 0;
+    /* Print depth and rollouts/sec to stderr every turn. */
+    bool verbose = false;
+  };
+
+  SearchRunner() : SearchRunner(Config()) {}
+  SearchRunner(Config const& config) : config_(config), random_(config.seed) {
+    if (config.table_mb > 0) {
+      table_ = std::make_unique<TranspositionTable>(config.table_mb);
+    }
+  }
+
+  void SetStreams(std::istream& input, std::ostream& output) override {
+    input_ = &input;
+    output_ = &output;
+  };
+
+  void Setup() override;
+  void Turn() override;
+  void Reset() override;
+  void Resume(RaceProgress const& progress) override;
+
+  unsigned long rollouts() const { return rollouts_; }
+  double rollouts_per_second() const { return seconds_ > 0 ? rollouts_ / seconds_ : 0.0; }
+  unsigned int depth() const { return depth_; }
+  TranspositionTable const* table() const { return table_.get(); }
+
+ private:
+  static int constexpr kShield = -1;
+  static int constexpr kBoost = -2;
+
+  struct Move {
+    double angle; /* degrees, relative to the pod's heading */
+    int thrust;   /* 0-100, kShield or kBoost */
+  };
+  /* depth_ turns of moves for both pods, turn-major. */
+  struct Plan {
+    std::vector<Move> moves;
+    double score;
+  };
+
+  struct PodTracker {
+    PodData input = PodData();
+    unsigned int laps = 0;
+    unsigned int last_checkpoint = 1;
+    int shield_cooldown = 0;
+  };
+
+  void ReadInput();
+  ForwardState CurrentState() const;
+  unsigned int ChooseDepth() const;
+  double Evaluate(Plan const& plan, ForwardState const& start) const;
+  double Leaf(ForwardState const& state) const;
+  double Heuristic(ForwardState const& state) const;
+  double Progress(Pod const& pod) const;
+  void ToControl(Move const& move, Pod const& pod, PodControl& control) const;
+  Move RandomMove();
+  void Mutate(Plan& plan);
+  double Uniform();
+
+  Config config_;
+  uint64_t random_;
+  std::unique_ptr<MapData> map_data_;
+  std::unique_ptr<ForwardModel> model_;
+  std::unique_ptr<TranspositionTable> table_;
+  std::istream* input_;
+  std::ostream* output_;
+  PodTracker pods_[ForwardState::kPods];
+  int boosts_left_ = 1;
+  bool first_turn_ = true;
+  unsigned int depth_ = 0;
+  Plan best_;
+  double steps_per_second_ = 1e6;
+  unsigned long rollouts_ = 0;
+  double seconds_ = 0.0;
+};
+
+#endif
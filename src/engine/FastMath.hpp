@@ -0,0 +1,91 @@
+#ifndef FASTMATH_HPP
+#define FASTMATH_HPP
+
+#include <math.h>
+#include <cmath>
+
+/* Trig for angle bookkeeping. By default Atan, Sin and Cos are the standard library's; with
+ * -DPODRACING_FAST_MATH (make FAST_MATH=1) they are the polynomials below. The protocol only
+ * carries whole degrees, and the bench checks how often the approximations change one. */
+namespace fastmath {
+
+double constexpr kPi = 3.14159265358979323846;
+
+/* atan on [-1, 1] by an odd minimax polynomial, the rest by atan(z) = ±pi/2 - atan(1/z).
+ * Error below 1e-5 rad (0.0006 degrees). */
+inline double ApproxAtan(double z) {
+  double t = std::fabs(z);
+  if (t == 1.0) {
+    /* Diagonals land exactly on 45 degrees, where truncating would turn any error into one. */
+    return z < 0 ? -kPi / 4 : kPi / 4;
+  }
+  bool invert = t > 1.0;
+  if (invert) {
+    t = 1.0 / t;
+  }
+  double t2 = t * t;
+  double r = t * (0.99997726 +
+                  t2 * (-0.33262347 +
+                        t2 * (0.19354346 + t2 * (-0.11643287 + t2 * (0.05265332 +
+                                                                     t2 * -0.01172120)))));
+  if (invert) {
+    r = kPi / 2 - r;
+  }
+  return z < 0 ? -r : r;
+}
+
+/* Reduced to [-pi/2, pi/2], then Taylor to x^11. Error below 1e-7. */
+inline double ApproxSin(double x) {
+  x -= std::nearbyint(x / (2 * kPi)) * (2 * kPi);
+  if (x > kPi / 2) {
+    x = kPi - x;
+  } else if (x < -kPi / 2) {
+    x = -kPi - x;
+  }
+  double x2 = x * x;
+  return x * (1.0 + x2 * (-1.0 / 6 + x2 * (1.0 / 120 + x2 * (-1.0 / 5040 +
+                                                            x2 * (1.0 / 362880 +
+                                                                  x2 * -1.0 / 39916800)))));
+}
+
+inline double ApproxCos(double x) { return ApproxSin(x + kPi / 2); }
+
+inline double ExactAtan(double z) { return std::atan(z); }
+inline double ExactSin(double x) { return std::sin(x); }
+inline double ExactCos(double x) { return std::cos(x); }
+
+#ifdef PODRACING_FAST_MATH
+inline double Atan(double z) { return ApproxAtan(z); }
+inline double Sin(double x) { return ApproxSin(x); }
+inline double Cos(double x) { return ApproxCos(x); }
+#else
+inline double Atan(double z) { return ExactAtan(z); }
+inline double Sin(double x) { return ExactSin(x); }
+inline double Cos(double x) { return ExactCos(x); }
+#endif
+
+/* The heading of (x, y) in whole degrees, [0, 360), as the referee reports it: atan(y / x)
+ * truncated towards zero, then moved into the right half plane. */
+template <double (*atan)(double) = Atan>
+int Degrees(double x, double y) {
+  int angle = static_cast<int>(atan(y / x) * 180 / kPi);
+
+  if (x < 0) {
+    angle += 180;
+  } else if (x == 0) {
+    if (y > 0) {
+      angle = 90;
+    } else {
+      angle = 270;
+    }
+  }
+  if (angle < 0) {
+    angle += 360;
+  }
+
+  return angle;
+}
+
+}  // namespace fastmath
+
+#endif
@@ -0,0 +1,259 @@
+#include "ForwardModel.hpp"
+#include <algorithm>
+#include "GameServer.hpp"
+
+template <typename T>
+ForwardStateT<T> ForwardStateT<T>::FromScenario(Scenario const& scenario) {
+  ForwardStateT state;
+  for (unsigned int p = 0; p < 2; ++p) {
+    state.timeout[p] = scenario.players[p].timeout;
+    state.boosts_available[p] = scenario.players[p].boosts_available;
+    for (unsigned int i = 0; i < 2; ++i) {
+      state.pods[p * 2 + i].SetState(scenario.players[p].pods[i]);
+    }
+  }
+  return state;
+}
+
+template <typename T>
+int ForwardModelT<T>::Step(State& state, PodControl const (&controls)[State::kPods],
+                           bool first_frame) const {
+  for (unsigned int i = 0; i < State::kPods; ++i) {
+    state.pods[i].SetTurnConditions(controls[i], state.boosts_available[i / 2], first_frame);
+  }
+
+  return EndTurn(state, ResolveCollisions(state));
+}
+
+template <typename T>
+void ForwardModelT<T>::StepCandidates(State const& state,
+                                      PodControl const (&controls)[State::kPods],
+                                      unsigned int pod, std::vector<PodControl> const& candidates,
+                                      std::vector<State>& results, std::vector<int>& winners,
+                                      bool first_frame) const {
+  unsigned int const player = pod / 2;
+  unsigned int const teammate = pod ^ 1;
+
+  /* Turn every other pod once. A teammate after the candidate sees the boost count the
+   * candidate leaves, which only matters when both boost; that case is redone below. */
+  State turned = state;
+  for (unsigned int i = 0; i < State::kPods; ++i) {
+    if (i != pod) {
+      turned.pods[i].SetTurnConditions(controls[i], turned.boosts_available[i / 2], first_frame);
+    }
+  }
+  int const boosts_before = teammate > pod ? state.boosts_available[player]
+                                           : turned.boosts_available[player];
+
+  /* The candidate only changes its own velocity, so the first collision search among the
+   * other pods is the same for all of them. */
+  Collisions shared;
+  for (unsigned int i = 0; i < State::kPods; ++i) {
+    if (i != pod) {
+      FindCheckpointCollision(turned, i, 1.0, shared);
+      for (unsigned int j = i + 1; j < State::kPods; ++j) {
+        if (j != pod) {
+          FindPodCollision(turned, i, j, 1.0, shared);
+        }
+      }
+    }
+  }
+
+  results.resize(candidates.size());
+  winners.resize(candidates.size());
+  for (unsigned int k = 0; k < candidates.size(); ++k) {
+    State& result = results[k];
+    result = turned;
+    int boosts = boosts_before;
+    result.pods[pod] = state.pods[pod];
+    result.pods[pod].SetTurnConditions(candidates[k], boosts, first_frame);
+    bool redo_teammate = teammate > pod && boosts != boosts_before;
+    if (redo_teammate) {
+      result.pods[teammate] = state.pods[teammate];
+      result.pods[teammate].SetTurnConditions(controls[teammate], boosts, first_frame);
+    }
+    if (teammate < pod || redo_teammate) {
+      result.boosts_available[player] = boosts;
+    }
+
+    Collisions first = shared;
+    for (unsigned int changed : {pod, teammate}) {
+      if (changed == teammate && !redo_teammate) {
+        continue;
+      }
+      FindCheckpointCollision(result, changed, 1.0, first);
+      for (unsigned int i = 0; i < State::kPods; ++i) {
+        if (i != changed) {
+          FindPodCollision(result, std::min(i, changed), std::max(i, changed), 1.0, first);
+        }
+      }
+    }
+
+    winners[k] = EndTurn(result, ResolveCollisions(result, &first));
+  }
+}
+
+template <typename T>
+PodControl ForwardModelT<T>::Predict(PodT<T> const& pod) const {
+  Vec2T<T> target = map_[pod.next_checkpoint()] - pod.velocity() * 3;
+  return {static_cast<int>(target.x()), static_cast<int>(target.y()), "100"};
+}
+
+template <typename T>
+void ForwardModelT<T>::FindCheckpointCollision(State const& state, unsigned int i, T time_left,
+                                               Collisions& collisions) const {
+  PodT<T> const& pod = state.pods[i];
+  Vec2T<T> const& checkpoint = map_[pod.next_checkpoint()];
+  T time;
+  collisions.checkpoint[i] = 2.0;
+  if (GameController::MayCollide(pod.position(), pod.velocity(), 0, checkpoint, Vec2T<T>(), 600,
+                                 time_left) &&
+      GameController::GetNextCollision(pod.position(), pod.velocity(), 0, checkpoint, Vec2T<T>(),
+                                       600, time) &&
+      time < 1.0) {
+    collisions.checkpoint[i] = time;
+  }
+}
+
+template <typename T>
+void ForwardModelT<T>::FindPodCollision(State const& state, unsigned int i, unsigned int j,
+                                        T time_left, Collisions& collisions) {
+  PodT<T> const& pod1 = state.pods[i];
+  PodT<T> const& pod2 = state.pods[j];
+  T time;
+  collisions.pair[PairIndex(i, j)] = 2.0;
+  if (GameController::MayCollide(pod1.position(), pod1.velocity(), 400, pod2.position(),
+                                 pod2.velocity(), 400, time_left) &&
+      GameController::GetNextCollision(pod1.position(), pod1.velocity(), 400, pod2.position(),
+                                       pod2.velocity(), 400, time) &&
+      time < 1.0) {
+    collisions.pair[PairIndex(i, j)] = time;
+  }
+}
+
+/* GameController::ResolveCollisions over a fixed set of pods. */
+template <typename T>
+T ForwardModelT<T>::ResolveCollisions(State& state, Collisions const* first) const {
+  PodT<T>* pods = state.pods;
+  unsigned int constexpr n = State::kPods;
+
+  T turn_time_remaining = 1.0;
+  for (unsigned int t = 0; t < 1000; ++t) {
+    Collisions found;
+    if (t == 0 && first != nullptr) {
+      found = *first;
+    } else {
+      for (unsigned int i = 0; i < n; ++i) {
+        FindCheckpointCollision(state, i, turn_time_remaining, found);
+        for (unsigned int j = i + 1; j < n; ++j) {
+          FindPodCollision(state, i, j, turn_time_remaining, found);
+        }
+      }
+    }
+
+    /* Earliest first, lowest index on ties, as GameController scans them. */
+    T dt_checkpoint = 2.0;
+    PodT<T>* pod_checkpoint = nullptr;
+    for (unsigned int i = 0; i < n; ++i) {
+      if (found.checkpoint[i] < dt_checkpoint) {
+        dt_checkpoint = found.checkpoint[i];
+        pod_checkpoint = &pods[i];
+      }
+    }
+
+    T dt_pod = 2.0;
+    PodT<T>* pod_collision_1 = nullptr;
+    PodT<T>* pod_collision_2 = nullptr;
+    for (unsigned int i = 0; i < n - 1; ++i) {
+      for (unsigned int j = i + 1; j < n; ++j) {
+        if (found.pair[PairIndex(i, j)] < dt_pod) {
+          dt_pod = found.pair[PairIndex(i, j)];
+          pod_collision_1 = &pods[i];
+          pod_collision_2 = &pods[j];
+        }
+      }
+    }
+
+    bool checkpoint_collision = pod_checkpoint != nullptr;
+    bool pod_collision = pod_collision_1 != nullptr;
+    if (checkpoint_collision && pod_collision) {
+      if (dt_checkpoint < dt_pod) {
+        pod_collision = false;
+      } else {
+        checkpoint_collision = false;
+      }
+    }
+
+    if (checkpoint_collision && dt_checkpoint <= turn_time_remaining) {
+      for (unsigned int i = 0; i < n; ++i) {
+        pods[i].Advance(dt_checkpoint);
+      }
+      turn_time_remaining -= dt_checkpoint;
+      pod_checkpoint->MakeProgress(dt_checkpoint, map_.size());
+      continue;
+    }
+
+    if (pod_collision && dt_pod <= turn_time_remaining) {
+      for (unsigned int i = 0; i < n; ++i) {
+        pods[i].Advance(dt_pod);
+      }
+      turn_time_remaining -= dt_pod;
+      PodT<T>::CollidePods(*pod_collision_1, *pod_collision_2);
+      continue;
+    }
+
+    break;
+  }
+
+  return turn_time_remaining;
+}
+
+/* Player::EndTurn and GameController::GetWinner. */
+template <typename T>
+int ForwardModelT<T>::EndTurn(State& state, T turn_time_remaining) const {
+  bool has_won[2] = {false, false};
+  T win_time[2] = {1.0, 1.0};
+  bool has_lost[2] = {false, false};
+  for (unsigned int p = 0; p < 2; ++p) {
+    bool progress = false;
+    for (unsigned int i = p * 2; i < p * 2 + 2; ++i) {
+      PodT<T>& pod = state.pods[i];
+      pod.Advance(turn_time_remaining);
+      if (pod.made_progress()) {
+        progress = true;
+        if (pod.has_won()) {
+          has_won[p] = true;
+          win_time[p] = pod.progress_time();
+        }
+      }
+      pod.EndTurn();
+    }
+
+    if (progress) {
+      state.timeout[p] = 100;
+    } else if (state.timeout[p] > 0) {
+      state.timeout[p]--;
+    } else {
+      has_lost[p] = true;
+    }
+  }
+
+  if (has_won[0] && (!has_won[1] || win_time[0] <= win_time[1])) {
+    return 0;
+  }
+  if (has_won[1]) {
+    return 1;
+  }
+  if (has_lost[0] && has_lost[1]) {
+    return -2;
+  }
+  if (has_lost[0] || has_lost[1]) {
+    return has_lost[0] ? 1 : 0;
+  }
+  return -1;
+}
+
+template struct ForwardStateT<double>;
+template struct ForwardStateT<float>;
+template class ForwardModelT<double>;
+template class ForwardModelT<float>;
@@ -0,0 +1,85 @@
+#ifndef FORWARDMODEL_HPP
+#define FORWARDMODEL_HPP
+
+#include <vector>
+#include "Pod.hpp"
+#include "Scenario.hpp"
+#include "Vec2.hpp"
+
+/* Everything a turn of the race changes, for two players with two pods each. Pods 0 and 1 belong
+ * to player 0, pods 2 and 3 to player 1. */
+template <typename T>
+struct ForwardStateT {
+  static unsigned int constexpr kPods = 4;
+
+  PodT<T> pods[kPods];
+  int timeout[2] = {100, 100};
+  int boosts_available[2] = {1, 1};
+
+  static ForwardStateT FromScenario(Scenario const& scenario);
+};
+
+typedef ForwardStateT<double> ForwardState;
+
+/* The referee's turn rules, as GameController plays them, without players, controllers or
+ * allocation, so a search can copy a state and play it forward cheaply. With T = double, Step
+ * gives the same result as GameController::Turn for the same commands; ForwardModelT<float> plays
+ * the same rules in single precision. */
+template <typename T>
+class ForwardModelT {
+ public:
+  typedef ForwardStateT<T> State;
+
+  ForwardModelT(std::vector<Vec2> const& map) : map_(map.begin(), map.end()) {}
+
+  /* Plays one turn in place. Returns the winner (0 or 1), -2 if both players lost, else -1. */
+  int Step(State& state, PodControl const (&controls)[State::kPods],
+           bool first_frame = false) const;
+
+  /* What-if for one pod: results[k] and winners[k] are what Step would give with
+   * controls[pod] replaced by candidates[k]. The other pods are turned once, and the part of the
+   * first collision search that does not involve the candidate pod is shared by every candidate.
+   * The output vectors are resized, so reusing them across calls avoids allocation. */
+  void StepCandidates(State const& state, PodControl const (&controls)[State::kPods],
+                      unsigned int pod, std::vector<PodControl> const& candidates,
+                      std::vector<State>& results, std::vector<int>& winners,
+                      bool first_frame = false) const;
+
+  /* A command for a pod nobody is controlling: full thrust at its next checkpoint, aimed off by
+   * three turns of velocity so it does not orbit the checkpoint. */
+  PodControl Predict(PodT<T> const& pod) const;
+
+  std::vector<Vec2T<T>> const& map() const { return map_; }
+
+ private:
+  static unsigned int constexpr kPairs = State::kPods * (State::kPods - 1) / 2;
+
+  /* Time of the next checkpoint crossing of each pod and next collision of each pair of pods
+   * (0-1, 0-2, 0-3, 1-2, 1-3, 2-3), or 2.0 if there is none this turn. */
+  struct Collisions {
+    T checkpoint[State::kPods];
+    T pair[kPairs];
+  };
+
+  static unsigned int PairIndex(unsigned int i, unsigned int j) {
+    return i * (2 * State::kPods - i - 1) / 2 + j - i - 1;
+  }
+  /* Events that cannot happen within time_left may be reported as 2.0. */
+  void FindCheckpointCollision(State const& state, unsigned int i, T time_left,
+                               Collisions& collisions) const;
+  static void FindPodCollision(State const& state, unsigned int i, unsigned int j, T time_left,
+                               Collisions& collisions);
+  T ResolveCollisions(State& state, Collisions const* first = nullptr) const;
+  int EndTurn(State& state, T turn_time_remaining) const;
+
+  std::vector<Vec2T<T>> map_;
+};
+
+typedef ForwardModelT<double> ForwardModel;
+
+extern template struct ForwardStateT<double>;
+extern template struct ForwardStateT<float>;
+extern template class ForwardModelT<double>;
+extern template class ForwardModelT<float>;
+
+#endif
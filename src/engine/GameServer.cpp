@@ -2,25 +2,23 @@
 #include <math.h>
 #include <cstdlib>
 #include <iostream>
+#include "TextProtocol.hpp"
 
 void GameController::AddPlayer(IPlayer& player) {
   players_.push_back(std::make_unique<Player>(player));
+  over_budget_.push_back(0);
 }
 
-void GameController::InitMap() {
-  /* Populate checkpoints */
+void GameController::RandomMap(std::vector<Vec2>& map) {
+  map.clear();
   int num_checkpoints = 2 + std::rand() % 7;
 
-  std::ostringstream map_string;
-  map_string << 3 << std::endl;  // laps
-  map_string << num_checkpoints << std::endl;
-
   for (int i = 0; i < num_checkpoints; ++i) {
     while (true) {
       double closest = INFINITY;
       Vec2 candidate(std::rand() % 16000, std::rand() % 9000);
-      for (unsigned int j = 0; j < map_.size(); ++j) {
-        double distance = (map_[j] - candidate).Length();
+      for (unsigned int j = 0; j < map.size(); ++j) {
+        double distance = (map[j] - candidate).Length();
 
         if (distance < closest) {
           closest = distance;
@@ -28,16 +26,38 @@ void GameController::InitMap() {
       }
 
       if (closest > 1200) {
-        map_.push_back(candidate);
+        map.push_back(candidate);
         break;
       }
     }
-    map_string << map_.back().x() << " " << map_.back().y() << std::endl;
   }
+}
+
+std::string GameController::MapInput(std::vector<Vec2> const& map) {
+  /* Checkpoints are whole numbers, so this is the text operator<< would give. */
+  std::string map_string = "3\n";  // laps
+  protocol::AppendInt(map_string, map.size());
+  map_string += '\n';
+  for (auto const& checkpoint : map) {
+    protocol::AppendInt(map_string, static_cast<int>(checkpoint.x()));
+    map_string += ' ';
+    protocol::AppendInt(map_string, static_cast<int>(checkpoint.y()));
+    map_string += '\n';
+  }
+  return map_string;
+}
+
+void GameController::InitMap() {
+  /* Populate checkpoints */
+  RandomMap(map_);
+  SendMap();
+}
 
+void GameController::SendMap() {
   /* Send map to players */
+  std::string map_string = MapInput(map_);
   for (auto& player : players_) {
-    player->Setup(map_string.str());
+    player->Setup(map_string);
   }
 }
 
@@ -61,37 +81,64 @@ void GameController::InitPods() {
 }
 
 int GameController::Turn() {
+  PERF_REGION(kRegionTurn);
+  STATS_COUNT(kTurns, 1);
+  STATS_PHASE(kPhaseInput);
   /* Tell players the current game state. */
-  std::vector<std::ostringstream> player_data(players_.size());
+  std::vector<std::string> player_data(players_.size());
 
   for (unsigned int i = 0; i < players_.size(); ++i) {
     players_[i]->GetGameInput(player_data[i]);
   }
 
   for (unsigned int i = 0; i < players_.size(); ++i) {
-    std::string player_input = player_data[i].str();
+    std::string player_input = player_data[i];
 
     for (unsigned int j = 0; j < players_.size(); ++j) {
       if (i == j) {
         continue;
       }
 
-      player_input += player_data[j].str();
+      player_input += player_data[j];
     }
 
     players_[i]->SetInitialTurnConditions(player_input, frame_count == 0);
+    CheckLatency(i);
+  }
+
+  STATS_NEXT_PHASE(kPhaseCollisions);
+  double turn_time_remaining = 1.0;
+  if (fidelity_ == Fidelity::Full) {
+    turn_time_remaining = ResolveCollisions();
+  } else {
+    ResolveCheckpoints();
+  }
+
+  STATS_NEXT_PHASE(kPhaseEndTurn);
+  for (auto& player : players_) {
+    player->AdvancePods(turn_time_remaining);
+    player->EndTurn();
   }
 
+  frame_count++;
+  return GetWinner();
+}
+
+/* Step through the turn one collision at a time, returning the time left after the last one. */
+double GameController::ResolveCollisions() {
   double turn_time_remaining = 1.0;
-  for (unsigned int t = 0; t < 1000; ++t) {
+  unsigned int t = 0;
+  for (; t < 1000; ++t) {
     double dt_checkpoint;
     Pod* pod_checkpoint = nullptr;
     double dt_pod;
     Pod* pod_collision_1 = nullptr;
     Pod* pod_collision_2 = nullptr;
 
-    bool checkpoint_collision = GetNextCheckpointCollision(dt_checkpoint, pod_checkpoint);
-    bool pod_collision = GetNextPlayerCollision(dt_pod, pod_collision_1, pod_collision_2);
+    bool checkpoint_collision = GetNextCheckpointCollision(turn_time_remaining, dt_checkpoint,
+                                                           pod_checkpoint);
+    bool pod_collision = GetNextPlayerCollision(turn_time_remaining, dt_pod, pod_collision_1,
+                                                 pod_collision_2);
 
     if (checkpoint_collision && pod_collision) {
       if (dt_checkpoint < dt_pod) {
@@ -107,6 +154,7 @@ int GameController::Turn() {
       }
       turn_time_remaining -= dt_checkpoint;
       pod_checkpoint->MakeProgress(dt_checkpoint, map_.size());
+      STATS_COUNT(kCheckpointCollisions, 1);
       continue;
     }
 
@@ -116,19 +164,51 @@ int GameController::Turn() {
       }
       turn_time_remaining -= dt_pod;
       Pod::CollidePods(*pod_collision_1, *pod_collision_2);
+      STATS_COUNT(kPodCollisions, 1);
       continue;
     }
 
     break;
   }
 
+  STATS_COUNT(kSubSteps, t);
+  STATS_COUNT(kSubStepCapHits, t == 1000);
+  STATS_HISTOGRAM(kSubStepsPerTurn, t);
+  return turn_time_remaining;
+}
+
+/* Screening approximation: pods pass through each other, and each pod can reach at most one
+ * checkpoint per turn. Positions are advanced by the caller. */
+void GameController::ResolveCheckpoints() {
   for (auto& player : players_) {
-    player->AdvancePods(turn_time_remaining);
-    player->EndTurn();
+    for (auto& pod : player->pods()) {
+      double time;
+      Vec2 const& checkpoint = map_.at(pod->next_checkpoint());
+      if (MayCollide(pod->position(), pod->velocity(), 0, checkpoint, Vec2(), 600, 1.0) &&
+          GetNextCollision(pod->position(), pod->velocity(), 0, checkpoint, Vec2(), 600, time) &&
+          time < 1.0) {
+        pod->MakeProgress(time, map_.size());
+        STATS_COUNT(kCheckpointCollisions, 1);
+      }
+    }
   }
+}
 
-  frame_count++;
-  return GetWinner();
+void GameController::CheckLatency(unsigned int index) {
+  Player& player = *players_[index];
+  double ms = player.last_turn_ns() / 1e6;
+  double budget = latency_budget_.turn_ms;
+  if (frame_count == 0) {
+    ms += player.last_setup_ns() / 1e6;
+    budget = latency_budget_.first_turn_ms;
+  }
+
+  if (ms > budget) {
+    over_budget_[index]++;
+    if (latency_budget_.enforce) {
+      player.TimeOut();
+    }
+  }
 }
 
 int GameController::GetWinner() const {
@@ -164,40 +244,351 @@ int GameController::GetWinner() const {
   return -1;
 }
 
+void GameController::Reset() {
+  map_.clear();
+  frame_count = 0;
+  fitness_override_.clear();
+  partial_fitness_ = false;
+  for (auto& player : players_) {
+    player->Reset();
+  }
+}
+
 // Return winning player (0 or 1)
 int GameController::RunGame() {
   InitMap();
   InitPods();
+  fitness_override_.clear();
+  partial_fitness_ = false;
+  termination_report_.games++;
+  RecordTurn();
+
+  /* A heuristic stop that is being played out to measure its error. */
+  Prediction audit;
+  int audit_frame = 0;
 
   while (true) {
-    switch (Turn()) {
+    int winner = Turn();
+    RecordTurn();
+    if (scenario_capture_ && scenario_interval_ > 0 && frame_count % scenario_interval_ == 0 &&
+        winner == -1) {
+      scenario_capture_->Add(CaptureScenario());
+    }
+    if (winner == -1 && audit.kind == Prediction::None) {
+      Prediction prediction = PredictOutcome();
+      if (prediction.kind == Prediction::Proven) {
+        termination_report_.proven_stops++;
+        fitness_override_ = prediction.fitness;
+        return EndGame(prediction.winner);
+      }
+      if (prediction.kind == Prediction::Heuristic) {
+        unsigned long stops = ++termination_report_.heuristic_stops;
+        if (termination_.audit_interval > 0 && stops % termination_.audit_interval == 0) {
+          audit = prediction;
+          audit_frame = frame_count;
+        } else {
+          fitness_override_ = prediction.fitness;
+          return EndGame(prediction.winner);
+        }
+      }
+    }
+
+    switch (winner) {
       case -1:
         /* Nobody won or lost. */
         break;
       case 0:
         /* Player 0 won. */
-        return 0;
       case 1:
         /* Player 1 won. */
-        return 1;
       case -2:
         /* Both lost */
-        return -2;
+        if (audit.kind != Prediction::None) {
+          Audit(audit, winner, audit_frame);
+        }
+        return EndGame(winner);
+    }
+  }
+}
+
+int GameController::RunScenario(Scenario const& scenario, unsigned int horizon) {
+  map_ = scenario.map;
+  SendMap();
+  for (unsigned int i = 0; i < players_.size() && i < 2; ++i) {
+    Scenario::Team const& team = scenario.players[i];
+    players_[i]->SetState({team.pods[0], team.pods[1]}, team.timeout, team.boosts_available);
+  }
+  for (unsigned int i = 0; i < players_.size() && i < 2; ++i) {
+    RaceProgress progress;
+    for (unsigned int j = 0; j < 4; ++j) {
+      PodState const& pod = scenario.players[j < 2 ? i : 1 - i].pods[j % 2];
+      progress.laps[j] = pod.lap;
+      progress.next_checkpoints[j] = pod.next_checkpoint;
+    }
+    progress.boosts_available = scenario.players[i].boosts_available;
+    players_[i]->Resume(progress);
+  }
+
+  /* Pods already have a heading, so no free first-turn rotation, and controllers were told the
+   * race is under way. */
+  frame_count = std::max(scenario.frame, 1);
+  fitness_override_.clear();
+  partial_fitness_ = true;
+
+  for (unsigned int t = 0; t < horizon; ++t) {
+    int winner = Turn();
+    if (winner != -1) {
+      return winner;
+    }
+  }
+  return -1;
+}
+
+Scenario GameController::CaptureScenario() const {
+  Scenario scenario;
+  scenario.map = map_;
+  scenario.frame = frame_count;
+  for (unsigned int i = 0; i < players_.size() && i < 2; ++i) {
+    Player const& player = *players_[i];
+    Scenario::Team& team = scenario.players[i];
+    team.pods[0] = player.pods().at(0)->GetState();
+    team.pods[1] = player.pods().at(1)->GetState();
+    team.timeout = player.timeout();
+    team.boosts_available = player.boosts_available();
+  }
+  return scenario;
+}
+
+int GameController::EndGame(int winner) {
+  STATS_COUNT(kGames, 1);
+  STATS_HISTOGRAM(kGameLength, frame_count);
+  if (recorder_) {
+    recorder_->End();
+  }
+  return winner;
+}
+
+void GameController::RecordTurn() {
+  if (!recorder_) {
+    return;
+  }
+
+  /* Members, so that recording allocates only on the first turns. */
+  record_pods_.clear();
+  record_timeouts_.clear();
+  record_boosts_.clear();
+  for (auto const& player : players_) {
+    std::vector<PodControl> const& controls = player->last_controls();
+    for (unsigned int i = 0; i < player->pods().size(); ++i) {
+      ReplayPod record = {player->pods()[i].get(), 0, 0};
+      if (i < controls.size()) {
+        record.target_x = controls[i].x;
+        record.target_y = controls[i].y;
+      }
+      record_pods_.push_back(record);
     }
+    record_timeouts_.push_back(player->timeout());
+    record_boosts_.push_back(player->boosts_available());
+  }
+
+  if (frame_count == 0) {
+    recorder_->Begin(map_, record_pods_, record_timeouts_, record_boosts_);
+  } else {
+    recorder_->Record(record_pods_, record_timeouts_, record_boosts_);
   }
 }
 
 double GameController::GetFitness(unsigned int index) const {
+  if (!fitness_override_.empty()) {
+    /* The game was stopped early, report what the rest of it was predicted to do. */
+    return fitness_override_.at(index);
+  }
+
   Player const& player = *players_.at(index);
 
   /* +1 for each missing checkpoint */
-  double pod1_fitness = player.pods().at(0)->GetFitness(map_);
-  double pod2_fitness = player.pods().at(1)->GetFitness(map_);
+  double pod1_fitness = player.pods().at(0)->GetFitness(map_, partial_fitness_);
+  double pod2_fitness = player.pods().at(1)->GetFitness(map_, partial_fitness_);
 
   return std::min(pod1_fitness, pod2_fitness);
 }
 
-bool GameController::GetNextCheckpointCollision(double& dt, Pod*& pod) {
+GameController::Prediction GameController::PredictOutcome() const {
+  Prediction prediction;
+  if (players_.size() != 2 ||
+      (!termination_.proven && termination_.lead_checkpoints == 0 &&
+       termination_.stall_turns == 0)) {
+    return prediction;
+  }
+
+  int const total = 3 * map_.size();
+  double const max_fitness = total + 1;
+  for (unsigned int i = 0; i < players_.size(); ++i) {
+    prediction.fitness.push_back(GetFitness(i));
+  }
+
+  /* A player that cannot progress before its timeout loses unless the other player is guaranteed
+   * to time out no later. The winner is exact unless LatencyBudget::enforce forfeits a late
+   * response first; a stalled player's fitness is final, a racing winner's is extrapolated to the
+   * loser's timeout. */
+  if (termination_.proven) {
+    bool stalled[2] = {IsStalled(0, players_[0]->timeout() + 1),
+                       IsStalled(1, players_[1]->timeout() + 1)};
+    for (unsigned int i = 0; i < 2; ++i) {
+      unsigned int other = 1 - i;
+      if (!stalled[i]) {
+        continue;
+      }
+      if (players_[other]->timeout() > players_[i]->timeout()) {
+        prediction.kind = Prediction::Proven;
+        prediction.winner = other;
+        if (!stalled[other] && frame_count > 0) {
+          int progress = Progress(other);
+          int gained = (players_[i]->timeout() + 1) * progress / frame_count;
+          prediction.fitness[other] = (total - std::min(progress + gained, total)) / max_fitness;
+        }
+        return prediction;
+      }
+      if (stalled[other]) {
+        prediction.kind = Prediction::Proven;
+        prediction.winner = (players_[other]->timeout() == players_[i]->timeout()) ? -2 : i;
+        return prediction;
+      }
+    }
+  }
+
+  if (termination_.lead_checkpoints > 0 && frame_count > 0) {
+    int progress[2] = {Progress(0), Progress(1)};
+    for (unsigned int lead = 0; lead < 2; ++lead) {
+      unsigned int trail = 1 - lead;
+      if (progress[lead] - progress[trail] < static_cast<int>(termination_.lead_checkpoints)) {
+        continue;
+      }
+
+      /* Extrapolate both players at their average rate until the leader finishes. */
+      double turns_left = static_cast<double>(total - progress[lead]) * frame_count /
+                          std::max(progress[lead], 1);
+      int gained = static_cast<int>(turns_left * progress[trail] / frame_count);
+      int final_progress = std::min(progress[trail] + gained, total - 1);
+
+      prediction.kind = Prediction::Heuristic;
+      prediction.winner = lead;
+      prediction.fitness[lead] = 0.0;
+      prediction.fitness[trail] = (total - final_progress) / max_fitness;
+      return prediction;
+    }
+  }
+
+  if (termination_.stall_turns > 0) {
+    int limit = 100 - static_cast<int>(termination_.stall_turns);
+    int t0 = players_[0]->timeout();
+    int t1 = players_[1]->timeout();
+    if (t0 <= limit && t1 <= limit) {
+      prediction.kind = Prediction::Heuristic;
+      prediction.winner = (t0 == t1) ? -2 : (t0 > t1 ? 0 : 1);
+      return prediction;
+    }
+  }
+
+  return prediction;
+}
+
+/* True if no pod of the player can reach its checkpoint within the given number of turns, and no
+ * pods in the game can collide in that time (so the per-pod reach bound holds). */
+bool GameController::IsStalled(unsigned int player, int turns) const {
+  for (auto const& pod : players_[player]->pods()) {
+    double distance = (map_.at(pod->next_checkpoint()) - pod->position()).Length();
+    if (distance - 600 <= Reach(*pod, turns)) {
+      return false;
+    }
+  }
+  return !PodsCanMeet(turns);
+}
+
+bool GameController::PodsCanMeet(int turns) const {
+  std::vector<Pod const*> pods;
+  for (auto const& player : players_) {
+    for (auto const& pod : player->pods()) {
+      pods.push_back(pod.get());
+    }
+  }
+
+  for (unsigned int i = 0; i < pods.size(); ++i) {
+    for (unsigned int j = i + 1; j < pods.size(); ++j) {
+      double distance = (pods[i]->position() - pods[j]->position()).Length();
+      if (distance - 800 <= Reach(*pods[i], turns) + Reach(*pods[j], turns)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+/* Checkpoints passed by the player's best pod. */
+int GameController::Progress(unsigned int player) const {
+  int best = 0;
+  for (auto const& pod : players_[player]->pods()) {
+    int progress = pod->lap() * map_.size() + pod->next_checkpoint() - 1;
+    best = std::max(best, progress);
+  }
+  return best;
+}
+
+/* Upper bound on the distance a pod can cover in the given number of turns without collisions:
+ * a boost on the first turn, full thrust afterwards, plus a unit of rounding slack per turn. */
+double GameController::Reach(Pod const& pod, int turns) {
+  double speed = pod.velocity().Length() + 650;
+  double reach = 0.0;
+  for (int t = 0; t < turns; ++t) {
+    reach += speed + 1;
+    speed = speed * 0.85 + 100;
+  }
+  return reach;
+}
+
+void GameController::Audit(Prediction const& prediction, int winner, int stop_frame) {
+  termination_report_.audited++;
+  termination_report_.audited_turns_saved += frame_count - stop_frame;
+  if (winner != prediction.winner) {
+    termination_report_.winner_errors++;
+  }
+
+  double error = 0.0;
+  for (unsigned int i = 0; i < players_.size(); ++i) {
+    error += std::abs(GetFitness(i) - prediction.fitness[i]);
+  }
+  termination_report_.fitness_error_ppm += static_cast<unsigned long>(error * 1e6);
+}
+
+void TerminationReport::Print(std::ostream& output) const {
+  double audits = std::max<unsigned long>(audited, 1);
+  output << "termination: games " << games << " proven " << proven_stops << " heuristic "
+         << heuristic_stops << " audited " << audited << " winner error rate "
+         << winner_errors / audits << " mean fitness error " << fitness_error_ppm / audits / 1e6
+         << " mean turns saved " << audited_turns_saved / audits << std::endl;
+}
+
+TerminationReport GameController::termination_report_;
+
+void LatencyReport::Merge(std::string const& name, LatencyHistogram const& setup,
+                          LatencyHistogram const& turn) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& histograms = controllers_[name];
+  histograms.first.Merge(setup);
+  histograms.second.Merge(turn);
+}
+
+void LatencyReport::Print(std::ostream& output) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto const& controller : controllers_) {
+    controller.second.first.Print(output, controller.first + " setup");
+    controller.second.second.Print(output, controller.first + " turn");
+  }
+}
+
+LatencyReport GameController::latency_report_;
+
+bool GameController::GetNextCheckpointCollision(double time_left, double& dt, Pod*& pod) {
   /* Set 2.0 as the collision tme for each pod, since we only accept 1 or less as valid. */
   std::vector<Pod*> pods;
   std::vector<double> times;
@@ -214,7 +605,8 @@ bool GameController::GetNextCheckpointCollision(double& dt, Pod*& pod) {
     double time;
     Pod const* p = pods[i];
     Vec2 const& checkpoint = map_.at(p->next_checkpoint());
-    if (GetNextCollision(p->position(), p->velocity(), 0, checkpoint, Vec2(), 600, time)) {
+    if (MayCollide(p->position(), p->velocity(), 0, checkpoint, Vec2(), 600, time_left) &&
+        GetNextCollision(p->position(), p->velocity(), 0, checkpoint, Vec2(), 600, time)) {
       if (time < times[i] && time < 1.0) {
         times[i] = time;
         found = true;
@@ -237,7 +629,8 @@ bool GameController::GetNextCheckpointCollision(double& dt, Pod*& pod) {
   return true;
 }
 
-bool GameController::GetNextPlayerCollision(double& dt, Pod*& pod1, Pod*& pod2) {
+bool GameController::GetNextPlayerCollision(double time_left, double& dt, Pod*& pod1,
+                                            Pod*& pod2) {
   /* We need to check each pair of pods to see if they will collide, and find the earliest
    * collision. */
   std::vector<Pod*> pods;
@@ -262,7 +655,9 @@ bool GameController::GetNextPlayerCollision(double& dt, Pod*& pod1, Pod*& pod2)
       Pod const* p1 = pods[i];
       Pod const* p2 = pods[j];
 
-      if (GetNextCollision(p1->position(), p1->velocity(), 400, p2->position(), p2->velocity(), 400,
+      if (MayCollide(p1->position(), p1->velocity(), 400, p2->position(), p2->velocity(), 400,
+                     time_left) &&
+          GetNextCollision(p1->position(), p1->velocity(), 400, p2->position(), p2->velocity(), 400,
                            time)) {
         if (time < times[i][j] && time < 1.0) {
           times[i][j] = time;
@@ -290,17 +685,20 @@ bool GameController::GetNextPlayerCollision(double& dt, Pod*& pod1, Pod*& pod2)
   return true;
 }
 
-bool GameController::GetNextCollision(Vec2 const& p1, Vec2 const& v1, double r1, Vec2 const& p2,
-                                      Vec2 const& v2, double r2, double& dt) {
-  Vec2 dp = p2 - p1;
-  Vec2 dv = v2 - v1;
-  double r = r1 + r2;
+template <typename T>
+bool GameController::GetNextCollision(Vec2T<T> const& p1, Vec2T<T> const& v1,
+                                      typename Vec2T<T>::Scalar r1, Vec2T<T> const& p2,
+                                      Vec2T<T> const& v2, typename Vec2T<T>::Scalar r2,
+                                      typename Vec2T<T>::Scalar& dt) {
+  Vec2T<T> dp = p2 - p1;
+  Vec2T<T> dv = v2 - v1;
+  T r = r1 + r2;
 
-  double a = Vec2::Dot(dv, dv);
-  double b = 2 * Vec2::Dot(dv, dp);
-  double c = Vec2::Dot(dp, dp) - r * r;
+  T a = Vec2T<T>::Dot(dv, dv);
+  T b = 2 * Vec2T<T>::Dot(dv, dp);
+  T c = Vec2T<T>::Dot(dp, dp) - r * r;
 
-  double disc = b * b - 4 * a * c;
+  T disc = b * b - 4 * a * c;
 
   if (disc < 0) {
     /* No collisions */
@@ -318,13 +716,13 @@ bool GameController::GetNextCollision(Vec2 const& p1, Vec2 const& v1, double r1,
     }
   }
 
-  double t1 = (-b + sqrt(disc)) / (2 * a);
-  double t2 = (-b - sqrt(disc)) / (2 * a);
+  T t1 = (-b + std::sqrt(disc)) / (2 * a);
+  T t2 = (-b - std::sqrt(disc)) / (2 * a);
 
   /* Since the game logic will resolve collisions as they happen, we only care about the
    * smallest time, because that one represets when a collision starts. The larger number
    * represents when the collision ends. */
-  double t = std::min(t1, t2);
+  T t = std::min(t1, t2);
 
   if (t < 0) {
     /* Collision occured in negative time, so it never happened or will happen. */
@@ -333,4 +731,10 @@ bool GameController::GetNextCollision(Vec2 const& p1, Vec2 const& v1, double r1,
     dt = t;
     return true;
   }
-}
\ No newline at end of file
+}
+
+template bool GameController::GetNextCollision<double>(Vec2 const&, Vec2 const&, double,
+                                                       Vec2 const&, Vec2 const&, double, double&);
+template bool GameController::GetNextCollision<float>(Vec2T<float> const&, Vec2T<float> const&,
+                                                      float, Vec2T<float> const&,
+                                                      Vec2T<float> const&, float, float&);
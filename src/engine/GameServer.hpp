@@ -1,39 +1,186 @@
 #ifndef GAMESERVER_HPP
 #define GAMESERVER_HPP
 
+#include <atomic>
 #include <cmath>
 #include <iostream>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <sstream>
 #include <string>
 #include <vector>
 #include "IPlayer.hpp"
+#include "LatencyHistogram.hpp"
+#include "PerfCounters.hpp"
 #include "Player.hpp"
 #include "Pod.hpp"
+#include "Replay.hpp"
+#include "Scenario.hpp"
+#include "Stats.hpp"
 #include "Vec2.hpp"
 
+enum class Fidelity {
+  Full,   /* Exact referee rules. */
+  Screen  /* No pod-pair collisions, one checkpoint solve per pod per turn. */
+};
+
+/* When RunGame may stop before somebody finishes or times out. */
+struct TerminationPolicy {
+  /* Stop once a player provably times out first: none of its pods can reach a checkpoint, and no
+   * two pods can meet, before its timeout expires. The winner is exact, barring a forfeit under
+   * LatencyBudget::enforce; a winner still racing gets its fitness extrapolated to that timeout. */
+  bool proven = false;
+  /* Heuristic: stop once one player's best pod leads by this many checkpoints (0 = off). The
+   * trailing player's fitness is extrapolated from both players' checkpoint rates. */
+  unsigned int lead_checkpoints = 0;
+  /* Heuristic: stop once neither player has progressed for this many turns (0 = off). The player
+   * that would time out first loses. */
+  unsigned int stall_turns = 0;
+  /* Play every Nth heuristic stop to the end anyway and record how wrong it was (0 = never). */
+  unsigned int audit_interval = 0;
+};
+
+/* CodinGame's response deadlines. The first turn's budget also covers reading the map. */
+struct LatencyBudget {
+  double first_turn_ms = 1000.0;
+  double turn_ms = 75.0;
+  /* Over-budget turns are always counted; with enforce, the late player loses the game, as it
+   * would to the real referee. */
+  bool enforce = false;
+};
+
+/* Shared by every GameController so threads running evaluations can be summed in one place. */
+struct TerminationReport {
+  std::atomic<unsigned long> games{0};
+  std::atomic<unsigned long> proven_stops{0};
+  std::atomic<unsigned long> heuristic_stops{0};
+  std::atomic<unsigned long> audited{0};
+  std::atomic<unsigned long> winner_errors{0};
+  std::atomic<unsigned long> fitness_error_ppm{0};
+  std::atomic<unsigned long> audited_turns_saved{0};
+
+  void Print(std::ostream& output) const;
+};
+
+/* Controller latencies merged from many games, by controller name. Safe to share between
+ * threads. */
+class LatencyReport {
+ public:
+  void Merge(std::string const& name, LatencyHistogram const& setup, LatencyHistogram const& turn);
+  void Print(std::ostream& output) const;
+
+ private:
+  mutable std::mutex mutex_;
+  std::map<std::string, std::pair<LatencyHistogram, LatencyHistogram>> controllers_;
+};
+
 class GameController {
  public:
   void AddPlayer(IPlayer& player);
+  void SetFidelity(Fidelity fidelity) { fidelity_ = fidelity; }
+  void SetTermination(TerminationPolicy const& policy) { termination_ = policy; }
+  void SetLatencyBudget(LatencyBudget const& budget) { latency_budget_ = budget; }
+  static TerminationReport& termination_report() { return termination_report_; }
+  static LatencyReport& latency_report() { return latency_report_; }
 
   // Return winning player (0 or 1)
   int RunGame();
 
+  /* Ready the controller, its players and their controllers for another RunGame or RunScenario
+   * with the same players, reusing their allocations. Settings and latency counts are kept. */
+  void Reset();
+
+  /* Resume from a mid-race state and play at most horizon turns. Returns the winner, or -1 if
+   * the horizon ran out first; GetFitness then includes progress along the current leg. */
+  int RunScenario(Scenario const& scenario, unsigned int horizon);
+
+  /* Record the game state into library every interval turns of each RunGame. */
+  void SetScenarioCapture(ScenarioLibrary* library, unsigned int interval) {
+    scenario_capture_ = library;
+    scenario_interval_ = interval;
+  }
+  Scenario CaptureScenario() const;
+
+  /* Write the next RunGame to recorder, which must have been opened. The recorder is closed when
+   * the game ends. */
+  void SetRecorder(ReplayRecorder* recorder) { recorder_ = recorder; }
+
   double GetFitness(unsigned int player) const;
+  Player const& player(unsigned int index) const { return *players_.at(index); }
+  unsigned int over_budget_turns(unsigned int player) const { return over_budget_.at(player); }
+
+  /* Replace map with a new one from std::rand; the map as the protocol sends it to controllers. */
+  static void RandomMap(std::vector<Vec2>& map);
+  static std::string MapInput(std::vector<Vec2> const& map);
+
+  /* Earliest time from now on at which two moving circles touch, if they ever do. dt is output
+   * only: it is set on a hit and left untouched otherwise, so callers bound it themselves. */
+  template <typename T>
+  static bool GetNextCollision(Vec2T<T> const& p1, Vec2T<T> const& v1,
+                               typename Vec2T<T>::Scalar r1, Vec2T<T> const& p2,
+                               Vec2T<T> const& v2, typename Vec2T<T>::Scalar r2,
+                               typename Vec2T<T>::Scalar& dt);
+
+  /* Broad phase for GetNextCollision: false if the circles are too far apart for their relative
+   * speed to close the gap within `time`, so the exact solve cannot find a hit by then. Bounds
+   * the speed by |dvx| + |dvy| to stay clear of a sqrt; a unit of slack absorbs rounding. */
+  template <typename T>
+  static bool MayCollide(Vec2T<T> const& p1, Vec2T<T> const& v1, typename Vec2T<T>::Scalar r1,
+                         Vec2T<T> const& p2, Vec2T<T> const& v2, typename Vec2T<T>::Scalar r2,
+                         typename Vec2T<T>::Scalar time) {
+    Vec2T<T> dp = p2 - p1;
+    T reach = r1 + r2 + 1 + (std::abs(v2.x() - v1.x()) + std::abs(v2.y() - v1.y())) * time;
+    bool may_collide = Vec2T<T>::Dot(dp, dp) <= reach * reach;
+    STATS_COUNT(kBroadPhaseTests, 1);
+    STATS_COUNT(kBroadPhaseRejects, !may_collide);
+    return may_collide;
+  }
 
  private:
   void InitMap();
+  void SendMap();
   void InitPods();
   int Turn();
+  double ResolveCollisions();
+  void ResolveCheckpoints();
   int GetWinner() const;
-  bool GetNextCheckpointCollision(double& dt, Pod*& pod);
-  bool GetNextPlayerCollision(double& dt, Pod*& pod1, Pod*& pod2);
-  static bool GetNextCollision(Vec2 const& p1, Vec2 const& v1, double r1, Vec2 const& p2,
-                               Vec2 const& v2, double r2, double& dt);
+  void RecordTurn();
+  void CheckLatency(unsigned int player);
+  int EndGame(int winner);
+
+  struct Prediction {
+    enum Kind { None, Proven, Heuristic } kind = None;
+    int winner = -1;
+    std::vector<double> fitness;
+  };
+  Prediction PredictOutcome() const;
+  bool IsStalled(unsigned int player, int turns) const;
+  bool PodsCanMeet(int turns) const;
+  int Progress(unsigned int player) const;
+  static double Reach(Pod const& pod, int turns);
+  void Audit(Prediction const& prediction, int winner, int stop_frame);
+  /* Earliest event this sub-step; events that cannot happen within time_left may be skipped. */
+  bool GetNextCheckpointCollision(double time_left, double& dt, Pod*& pod);
+  bool GetNextPlayerCollision(double time_left, double& dt, Pod*& pod1, Pod*& pod2);
 
   std::vector<Vec2> map_;
   std::vector<std::unique_ptr<Player>> players_;
   int frame_count = 0;
+  Fidelity fidelity_ = Fidelity::Full;
+  TerminationPolicy termination_;
+  std::vector<double> fitness_override_;
+  static TerminationReport termination_report_;
+  static LatencyReport latency_report_;
+  bool partial_fitness_ = false;
+  ScenarioLibrary* scenario_capture_ = nullptr;
+  unsigned int scenario_interval_ = 0;
+  ReplayRecorder* recorder_ = nullptr;
+  std::vector<ReplayPod> record_pods_;
+  std::vector<int> record_timeouts_;
+  std::vector<int> record_boosts_;
+  LatencyBudget latency_budget_;
+  std::vector<unsigned int> over_budget_;
 };
 
 #endif
\ No newline at end of file
@@ -3,11 +3,26 @@
 
 #include <iostream>
 
+/* Where a game picked up mid-race stands, as one controller sees it: its own two pods, then the
+ * opponent's two, in protocol order. */
+struct RaceProgress {
+  int laps[4];
+  int next_checkpoints[4];
+  int boosts_available;
+};
+
 class IPlayer {
  public:
   virtual void SetStreams(std::istream& input, std::ostream& output) = 0;
   virtual void Setup() = 0;
   virtual void Turn() = 0;
+  /* Forget the last game so the controller can play another; Setup follows with the new map.
+   * Controllers that keep per-game state must override this to be reused across games. */
+  virtual void Reset() {}
+  /* Called after Setup when the game resumes mid-race (GameController::RunScenario): the first
+   * Turn is not the start of the race. Controllers that track laps, boosts or the first turn
+   * override this; the turn input alone does not carry them. */
+  virtual void Resume(RaceProgress const& progress) {}
 };
 
 #endif
\ No newline at end of file
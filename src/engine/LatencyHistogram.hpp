@@ -0,0 +1,100 @@
+#ifndef LATENCYHISTOGRAM_HPP
+#define LATENCYHISTOGRAM_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+/* Nanosecond latencies in log-linear buckets: exact below 16 ns, then 8 buckets per power of two,
+ * so percentiles are within 12.5% at any scale. The maximum is exact. */
+class LatencyHistogram {
+ public:
+  void Add(uint64_t ns) {
+    buckets_[Index(ns)]++;
+    count_++;
+    total_ += ns;
+    max_ = std::max(max_, ns);
+  }
+
+  /* Nanoseconds from start until now. */
+  static uint64_t Since(std::chrono::steady_clock::time_point start) {
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+  }
+
+  void Merge(LatencyHistogram const& other) {
+    for (unsigned int i = 0; i < kBuckets; ++i) {
+      buckets_[i] += other.buckets_[i];
+    }
+    count_ += other.count_;
+    total_ += other.total_;
+    max_ = std::max(max_, other.max_);
+  }
+
+  uint64_t count() const { return count_; }
+  uint64_t max() const { return max_; }
+  double mean() const { return count_ > 0 ? static_cast<double>(total_) / count_ : 0.0; }
+
+  /* Upper bound of the bucket holding the p-th quantile, p in [0, 1]. */
+  uint64_t Percentile(double p) const {
+    uint64_t rank = std::max<uint64_t>(1, std::ceil(p * count_));
+    uint64_t seen = 0;
+    for (unsigned int i = 0; i < kBuckets; ++i) {
+      seen += buckets_[i];
+      if (seen >= rank) {
+        return std::min(UpperBound(i), max_);
+      }
+    }
+    return max_;
+  }
+
+  /* Leaves the stream's formatting as it found it. */
+  void Print(std::ostream& output, std::string const& name) const {
+    std::ios::fmtflags flags = output.flags();
+    std::streamsize precision = output.precision();
+    output << std::left << std::setw(16) << name << std::right << " n=" << count_ << std::fixed
+           << std::setprecision(3) << " p50=" << Percentile(0.5) / 1e6
+           << "ms p99=" << Percentile(0.99) / 1e6 << "ms max=" << max_ / 1e6 << "ms"
+           << std::endl;
+    output.flags(flags);
+    output.precision(precision);
+  }
+
+ private:
+  static unsigned int constexpr kLinear = 16;
+  static unsigned int constexpr kSubBuckets = 8;
+  static unsigned int constexpr kBuckets = kLinear + (64 - 4) * kSubBuckets;
+
+  static unsigned int Index(uint64_t ns) {
+    if (ns < kLinear) {
+      return ns;
+    }
+    unsigned int msb = 4;
+    while (msb < 63 && (ns >> (msb + 1)) != 0) {
+      msb++;
+    }
+    unsigned int sub = (ns >> (msb - 3)) & (kSubBuckets - 1);
+    return kLinear + (msb - 4) * kSubBuckets + sub;
+  }
+
+  static uint64_t UpperBound(unsigned int index) {
+    if (index < kLinear) {
+      return index;
+    }
+    unsigned int msb = 4 + (index - kLinear) / kSubBuckets;
+    uint64_t sub = (index - kLinear) % kSubBuckets;
+    uint64_t width = uint64_t(1) << (msb - 3);
+    return ((kSubBuckets + sub) << (msb - 3)) + width - 1;
+  }
+
+  uint64_t buckets_[kBuckets] = {};
+  uint64_t count_ = 0;
+  uint64_t total_ = 0;
+  uint64_t max_ = 0;
+};
+
+#endif
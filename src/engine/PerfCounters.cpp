@@ -0,0 +1,190 @@
+#include "PerfCounters.hpp"
+#include <algorithm>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace perf {
+
+static char const* const kRegionNames[kRegionCount] = {"turn", "set_input", "breed"};
+static char const* const kCounterNames[kCounterCount] = {"cycles", "instructions", "l1d_misses",
+                                                         "llc_misses", "branch_misses"};
+
+/* Counters of running threads, and the totals of those that have exited. */
+static std::mutex registry_mutex;
+static std::vector<std::unique_ptr<ThreadCounters>> registry;
+static uint64_t retired_calls[kRegionCount] = {};
+static double retired_totals[kRegionCount][kCounterCount] = {};
+static unsigned long retired_threads = 0;
+static bool warned = false;
+
+#ifdef __linux__
+static int OpenCounter(uint32_t type, uint64_t config, int group) {
+  perf_event_attr attr = {};
+  attr.size = sizeof(attr);
+  attr.type = type;
+  attr.config = config;
+  attr.disabled = group == -1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format =
+      PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  /* pid 0, cpu -1: this thread, wherever it runs. */
+  return syscall(__NR_perf_event_open, &attr, 0, -1, group, 0);
+}
+
+static bool Open(ThreadCounters& counters) {
+  static uint64_t const kL1dReadMiss = PERF_COUNT_HW_CACHE_L1D |
+                                       (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                       (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+  struct {
+    uint32_t type;
+    uint64_t config;
+  } const events[kCounterCount] = {{PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+                                   {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+                                   {PERF_TYPE_HW_CACHE, kL1dReadMiss},
+                                   {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+                                   {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES}};
+
+  counters.group = -1;
+  for (unsigned int i = 0; i < kCounterCount; ++i) {
+    counters.fds[i] = OpenCounter(events[i].type, events[i].config, counters.group);
+    if (counters.fds[i] < 0) {
+      for (unsigned int j = 0; j < i; ++j) {
+        close(counters.fds[j]);
+      }
+      return false;
+    }
+    if (i == 0) {
+      counters.group = counters.fds[0];
+    }
+  }
+
+  ioctl(counters.group, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+  ioctl(counters.group, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  return true;
+}
+
+static void CloseEvents(ThreadCounters& counters) {
+  if (counters.available) {
+    for (int fd : counters.fds) {
+      close(fd);
+    }
+  }
+  counters.available = false;
+}
+
+bool Read(ThreadCounters const& counters, Sample& sample) {
+  uint64_t buffer[3 + kCounterCount];
+  if (read(counters.group, buffer, sizeof(buffer)) != sizeof(buffer)) {
+    return false;
+  }
+  sample.enabled = buffer[1];
+  sample.running = buffer[2];
+  for (unsigned int i = 0; i < kCounterCount; ++i) {
+    sample.values[i] = buffer[3 + i];
+  }
+  return true;
+}
+#else
+static bool Open(ThreadCounters&) { return false; }
+
+static void CloseEvents(ThreadCounters& counters) { counters.available = false; }
+
+bool Read(ThreadCounters const&, Sample&) { return false; }
+#endif
+
+ThreadCounters* Register() {
+  ThreadCounters* counters = new ThreadCounters();
+  counters->available = Open(*counters);
+
+  std::lock_guard<std::mutex> lock(registry_mutex);
+  if (!counters->available && !warned) {
+    std::cerr << "perf: hardware counters unavailable, only counting region calls" << std::endl;
+    warned = true;
+  }
+  registry.emplace_back(counters);
+  return counters;
+}
+
+void Close(ThreadCounters* counters) {
+  CloseEvents(*counters);
+
+  std::lock_guard<std::mutex> lock(registry_mutex);
+  for (unsigned int r = 0; r < kRegionCount; ++r) {
+    retired_calls[r] += counters->calls[r];
+    for (unsigned int i = 0; i < kCounterCount; ++i) {
+      retired_totals[r][i] += counters->totals[r][i];
+    }
+  }
+  retired_threads++;
+  registry.erase(std::find_if(registry.begin(), registry.end(),
+                              [counters](std::unique_ptr<ThreadCounters> const& entry) {
+                                return entry.get() == counters;
+                              }));
+}
+
+/* Leaves the stream's formatting as it found it, for callers that print between reports. */
+void Print(std::ostream& output) {
+  std::lock_guard<std::mutex> lock(registry_mutex);
+  uint64_t calls[kRegionCount];
+  double totals[kRegionCount][kCounterCount];
+  std::copy(retired_calls, retired_calls + kRegionCount, calls);
+  std::copy(&retired_totals[0][0], &retired_totals[0][0] + kRegionCount * kCounterCount,
+            &totals[0][0]);
+  for (auto const& local : registry) {
+    for (unsigned int r = 0; r < kRegionCount; ++r) {
+      calls[r] += local->calls[r];
+      for (unsigned int i = 0; i < kCounterCount; ++i) {
+        totals[r][i] += local->totals[r][i];
+      }
+    }
+  }
+
+  std::ios::fmtflags flags = output.flags();
+  std::streamsize precision = output.precision();
+  output << "perf: " << registry.size() + retired_threads << " threads" << std::endl;
+  output << "  " << std::left << std::setw(12) << "region" << std::right << std::setw(12)
+         << "calls";
+  for (unsigned int i = 0; i < kCounterCount; ++i) {
+    output << std::setw(16) << kCounterNames[i];
+  }
+  output << std::setw(8) << "ipc" << std::setw(12) << "llc/kinst" << std::setw(12)
+         << "br/kinst" << std::endl;
+
+  for (unsigned int r = 0; r < kRegionCount; ++r) {
+    if (calls[r] == 0) {
+      continue;
+    }
+    output << "  " << std::left << std::setw(12) << kRegionNames[r] << std::right
+           << std::setw(12) << calls[r] << std::fixed << std::setprecision(0);
+    for (unsigned int i = 0; i < kCounterCount; ++i) {
+      output << std::setw(16) << totals[r][i];
+    }
+    double kinstructions = totals[r][kInstructions] / 1000;
+    if (totals[r][kCycles] > 0 && kinstructions > 0) {
+      output << std::setprecision(2) << std::setw(8)
+             << totals[r][kInstructions] / totals[r][kCycles] << std::setw(12)
+             << totals[r][kLlcMisses] / kinstructions << std::setw(12)
+             << totals[r][kBranchMisses] / kinstructions;
+    }
+    output << std::endl;
+  }
+  output.flags(flags);
+  output.precision(precision);
+}
+
+#ifdef PODRACING_PERF
+static struct PrintAtExit {
+  ~PrintAtExit() { Print(std::cerr); }
+} print_at_exit;
+#endif
+
+}  // namespace perf
@@ -0,0 +1,100 @@
+#ifndef PERFCOUNTERS_HPP
+#define PERFCOUNTERS_HPP
+
+#include <cstdint>
+#include <iostream>
+
+/* Hardware counters around named regions, compiled in with -DPODRACING_PERF (make PERF=1) and
+ * printed to stderr at exit, or whenever PERF_PRINT is reached. Linux only: each thread opens one
+ * perf_event_open group, read on entry to and exit from a region. Elsewhere, or when the kernel
+ * refuses (see /proc/sys/kernel/perf_event_paranoid), regions only count calls. Nested regions are
+ * inclusive. */
+namespace perf {
+
+enum Region {
+  kRegionTurn,     /* GameController::Turn */
+  kRegionSetInput, /* NeuralNetwork::SetInput */
+  kRegionBreed,    /* GeneticAlgorithm selection and breeding */
+
+  kRegionCount
+};
+
+enum Counter {
+  kCycles,
+  kInstructions,
+  kL1dMisses,
+  kLlcMisses,
+  kBranchMisses,
+
+  kCounterCount
+};
+
+struct Sample {
+  uint64_t values[kCounterCount];
+  uint64_t enabled;
+  uint64_t running;
+};
+
+struct alignas(64) ThreadCounters {
+  int group;
+  int fds[kCounterCount];
+  bool available;
+  uint64_t calls[kRegionCount];
+  /* Scaled for multiplexing. */
+  double totals[kRegionCount][kCounterCount];
+};
+
+ThreadCounters* Register();
+/* Closes the counters, adds their totals to those of exited threads and frees them. */
+void Close(ThreadCounters* counters);
+bool Read(ThreadCounters const& counters, Sample& sample);
+void Print(std::ostream& output);
+
+/* Closes the thread's counters when it exits; Print still counts their totals. */
+struct LocalCounters {
+  ThreadCounters* counters = Register();
+  ~LocalCounters() { Close(counters); }
+};
+
+inline ThreadCounters& Local() {
+  thread_local LocalCounters local;
+  return *local.counters;
+}
+
+class Scope {
+ public:
+  Scope(Region region) : region_(region), counters_(Local()) {
+    valid_ = counters_.available && Read(counters_, start_);
+  }
+
+  ~Scope() {
+    counters_.calls[region_]++;
+    Sample end;
+    if (!valid_ || !Read(counters_, end)) {
+      return;
+    }
+    uint64_t running = end.running - start_.running;
+    double scale = running > 0 ? static_cast<double>(end.enabled - start_.enabled) / running : 0;
+    for (unsigned int i = 0; i < kCounterCount; ++i) {
+      counters_.totals[region_][i] += (end.values[i] - start_.values[i]) * scale;
+    }
+  }
+
+ private:
+  Region region_;
+  ThreadCounters& counters_;
+  Sample start_;
+  bool valid_;
+};
+
+}  // namespace perf
+
+#ifdef PODRACING_PERF
+#define PERF_REGION(region) perf::Scope perf_scope(perf::region)
+#define PERF_PRINT(output) perf::Print(output)
+#else
+#define PERF_REGION(region) ((void)0)
+#define PERF_PRINT(output) ((void)0)
+#endif
+
+#endif
@@ -1,4 +1,6 @@
 #include "Player.hpp"
+#include <chrono>
+#include "TextProtocol.hpp"
 
 Player::Player(IPlayer& controller)
     : controller_(controller), output_(), input_(), timeout_(100), boosts_available_(1) {
@@ -10,7 +12,10 @@ Player::Player(IPlayer& controller)
 void Player::Setup(std::string const& data) {
   input_.clear();
   input_.str(data);
+  auto start = std::chrono::steady_clock::now();
   controller_.Setup();
+  last_setup_ns_ = LatencyHistogram::Since(start);
+  setup_latency_.Add(last_setup_ns_);
 }
 
 void Player::InitPods(Vec2 const& origin, Vec2 const& direction, double seperation,
@@ -21,15 +26,39 @@ void Player::InitPods(Vec2 const& origin, Vec2 const& direction, double seperati
   pods_[1]->PointAt(target);
 }
 
+void Player::SetState(std::vector<PodState> const& pods, int timeout, int boosts_available) {
+  for (unsigned int i = 0; i < pods_.size() && i < pods.size(); ++i) {
+    pods_[i]->SetState(pods[i]);
+  }
+  timeout_ = timeout;
+  boosts_available_ = boosts_available;
+  has_won_ = false;
+  win_time_ = 1.0;
+  has_lost_ = false;
+}
+
+void Player::Reset() {
+  for (auto& pod : pods_) {
+    *pod = Pod();
+  }
+  last_controls_.clear();
+  timeout_ = 100;
+  boosts_available_ = 1;
+  has_won_ = false;
+  win_time_ = 1.0;
+  has_lost_ = false;
+  controller_.Reset();
+}
+
 void Player::SetInitialTurnConditions(std::string const& input_data, bool first_frame) {
-  std::vector<PodControl> control = CollectBotOutput(input_data);
+  last_controls_ = CollectBotOutput(input_data);
 
-  for (unsigned int i = 0; i < control.size(); ++i) {
-    pods_[i]->SetTurnConditions(control[i], boosts_available_, first_frame);
+  for (unsigned int i = 0; i < last_controls_.size(); ++i) {
+    pods_[i]->SetTurnConditions(last_controls_[i], boosts_available_, first_frame);
   }
 }
 
-void Player::GetGameInput(std::ostringstream& game_input) {
+void Player::GetGameInput(std::string& game_input) {
   for (auto const& pod : pods_) {
     pod->WritePodState(game_input);
   }
@@ -40,7 +69,7 @@ void Player::EndTurn() {
   for (auto& pod : pods_) {
     if (pod->made_progress()) {
       progress = true;
-      if (pod->has_won()) {
+      if (pod->has_won() && !has_lost_) {
         has_won_ = true;
         win_time_ = pod->progress_time();
       }
@@ -70,14 +99,17 @@ std::vector<PodControl> Player::CollectBotOutput(std::string const& input_data)
   output_.str("");
   output_.clear();
   input_.str(input_data);
+  auto start = std::chrono::steady_clock::now();
   controller_.Turn();
+  last_turn_ns_ = LatencyHistogram::Since(start);
+  turn_latency_.Add(last_turn_ns_);
 
-  std::istringstream actions(output_.str());
-  std::vector<PodControl> output;
-  for (unsigned int i = 0; i < pods_.size(); ++i) {
-    PodControl control;
-    actions >> control.x >> control.y >> control.action;
-    output.push_back(control);
+  std::string const actions = output_.str();
+  char const* in = actions.data();
+  char const* end = in + actions.size();
+  std::vector<PodControl> output(pods_.size());
+  for (PodControl& control : output) {
+    protocol::ParseCommand(in, end, control.x, control.y, control.action);
   }
 
   return output;
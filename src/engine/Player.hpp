@@ -7,6 +7,7 @@
 #include <string>
 #include <vector>
 #include "IPlayer.hpp"
+#include "LatencyHistogram.hpp"
 #include "Pod.hpp"
 #include "Vec2.hpp"
 
@@ -16,7 +17,7 @@ class Player {
   void Setup(std::string const& data);
   void InitPods(Vec2 const& origin, Vec2 const& direction, double seperation, Vec2 const& target);
   void SetInitialTurnConditions(std::string const& input_data, bool first_frame);
-  void GetGameInput(std::ostringstream& game_input);
+  void GetGameInput(std::string& game_input);
   void EndTurn();
   void AdvancePods(double dt);
 
@@ -24,12 +25,30 @@ class Player {
   bool has_won() const { return has_won_; }
   double win_time() const { return win_time_; }
   bool has_lost() const { return has_lost_; }
+  int timeout() const { return timeout_; }
+  int boosts_available() const { return boosts_available_; }
+  std::vector<PodControl> const& last_controls() const { return last_controls_; }
+  void SetState(std::vector<PodState> const& pods, int timeout, int boosts_available);
+  /* Back to the start of a game, controller included, keeping pods and stream buffers. Latency
+   * histograms keep accumulating. */
+  void Reset();
+  /* Tells the controller the game resumes mid-race. */
+  void Resume(RaceProgress const& progress) { controller_.Resume(progress); }
+
+  /* Wall time of the controller's Setup and Turn calls. */
+  LatencyHistogram const& setup_latency() const { return setup_latency_; }
+  LatencyHistogram const& turn_latency() const { return turn_latency_; }
+  uint64_t last_setup_ns() const { return last_setup_ns_; }
+  uint64_t last_turn_ns() const { return last_turn_ns_; }
+  /* The controller missed its deadline: it loses, as it would to the real referee. */
+  void TimeOut() { has_lost_ = true; }
 
  private:
   std::vector<PodControl> CollectBotOutput(std::string const& input_data);
 
   IPlayer& controller_;
   std::vector<std::unique_ptr<Pod>> pods_;
+  std::vector<PodControl> last_controls_;
   std::ostringstream output_;
   std::istringstream input_;
   int timeout_;
@@ -37,6 +56,10 @@ class Player {
   bool has_won_ = false;
   double win_time_ = 1.0;
   bool has_lost_ = false;
+  LatencyHistogram setup_latency_;
+  LatencyHistogram turn_latency_;
+  uint64_t last_setup_ns_ = 0;
+  uint64_t last_turn_ns_ = 0;
 };
 
 #endif
\ No newline at end of file
@@ -1,15 +1,32 @@
 #include "Pod.hpp"
 #include <cmath>
 #include <vector>
-
-void Pod::WritePodState(std::ostream& output) const {
-  output << static_cast<int>(position_.x()) << " " << static_cast<int>(position_.y()) << " "
-         << static_cast<int>(velocity_.x()) << " " << static_cast<int>(velocity_.y()) << " "
-         << direction_.Degrees() << " " << target_checkpoint_ << std::endl;
+#include "TextProtocol.hpp"
+
+template <typename T>
+void PodT<T>::WritePodState(std::string& output) const {
+  int const fields[] = {static_cast<int>(position_.x()),
+                        static_cast<int>(position_.y()),
+                        static_cast<int>(velocity_.x()),
+                        static_cast<int>(velocity_.y()),
+                        heading(),
+                        static_cast<int>(target_checkpoint_)};
+  char buffer[6 * protocol::kMaxIntChars + 6];
+  char* end = buffer;
+  for (int field : fields) {
+    end = protocol::FormatInt(end, field);
+    *end++ = ' ';
+  }
+  end[-1] = '\n';
+  output.append(buffer, end);
 }
 
-void Pod::SetTurnConditions(PodControl const& control, int& boosts_available, bool first_frame) {
-  static double const kMaxAngle = Vec2::pi() / 10;
+template <typename T>
+void PodT<T>::SetTurnConditions(PodControl const& control, int& boosts_available,
+                                bool first_frame) {
+  static double constexpr kMaxAngle = Vec2::pi() / 10;
+  static T const kCosMaxAngle = std::cos(kMaxAngle);
+  static T const kSinMaxAngle = std::sin(kMaxAngle);
 
   /* Figure out current thrust value */
   int boost = GetBoost(control, boosts_available);
@@ -18,16 +35,17 @@ void Pod::SetTurnConditions(PodControl const& control, int& boosts_available, bo
   }
 
   /* Turn vehicle as much as allowed */
-  Vec2 desired_direction = Vec2(control.x, control.y) - position_;
+  Vec2T<T> desired_direction = Vec2T<T>(control.x, control.y) - position_;
   desired_direction.Normalize();
-  double dot = Vec2::Cap(Vec2::Dot(direction_, desired_direction), 1.0);
+  T dot = Vec2T<T>::Cap(Vec2T<T>::Dot(direction_, desired_direction), 1.0);
 
-  double angle = std::acos(dot);
-  if (angle < kMaxAngle || first_frame) {
+  /* acos(dot) < kMaxAngle, without the acos. */
+  heading_ = -1;
+  if (dot > kCosMaxAngle || first_frame) {
     direction_ = desired_direction;
   } else {
-    double cross = Vec2::Cross(direction_, desired_direction);
-    direction_.Rotate(cross > 0 ? kMaxAngle : -kMaxAngle);
+    T cross = Vec2T<T>::Cross(direction_, desired_direction);
+    direction_.Rotate(kCosMaxAngle, cross > 0 ? kSinMaxAngle : -kSinMaxAngle);
   }
 
   /* Update speed by boost */
@@ -37,34 +55,41 @@ void Pod::SetTurnConditions(PodControl const& control, int& boosts_available, bo
   progress_time_ = 0.0;
 }
 
-int Pod::GetBoost(PodControl const& control, int& boosts_available) {
+template <typename T>
+int PodT<T>::GetBoost(PodControl const& control, int& boosts_available) {
+  /* Parsed once and kept, so that a replay can record the action without parsing it again. */
+  bool const boost = control.action == "BOOST";
   if (control.action == "SHIELD") {
+    action_ = kActionShield;
     mass_ = 10;
     shield_cooldown_ = 4;
   } else {
+    action_ = boost ? kActionBoost : std::atoi(control.action.c_str());
     mass_ = 1;
   }
   if (shield_cooldown_ > 0) {
     return 0;
   }
-  if (control.action == "BOOST") {
+  if (boost) {
     if (boosts_available > 0) {
       boosts_available--;
       return 650;
     }
     return 100;
   }
-  return std::atoi(control.action.c_str());
+  return action_;
 }
 
-void Pod::EndTurn() {
+template <typename T>
+void PodT<T>::EndTurn() {
   /* Apply friction */
   velocity_ *= 0.85;
   velocity_.Truncate();
   position_.Round();
 }
 
-void Pod::MakeProgress(double dt, unsigned int checkpoint_count) {
+template <typename T>
+void PodT<T>::MakeProgress(T dt, unsigned int checkpoint_count) {
   made_progress_ = true;
   progress_time_ = dt;
 
@@ -75,42 +100,49 @@ void Pod::MakeProgress(double dt, unsigned int checkpoint_count) {
   }
 }
 
-void Pod::Advance(double dt) { position_ += velocity_ * dt; }
+template <typename T>
+void PodT<T>::Advance(T dt) {
+  position_ += velocity_ * dt;
+}
 
-void Pod::SetPosition(Vec2 const& origin, Vec2 const& direction, double magnitude) {
+template <typename T>
+void PodT<T>::SetPosition(Vec2T<T> const& origin, Vec2T<T> const& direction, T magnitude) {
   position_ = origin + direction * magnitude;
   position_.Round();
 }
 
-void Pod::PointAt(Vec2 const& at) {
+template <typename T>
+void PodT<T>::PointAt(Vec2T<T> const& at) {
   direction_ = at - position_;
   direction_.Normalize();
+  heading_ = -1;
 }
 
-void Pod::CollidePods(Pod& pod1, Pod& pod2) {
-  Vec2 dp = pod2.position_ - pod1.position_;
-  Vec2 dv = pod2.velocity_ - pod1.velocity_;
-  double m =
-      static_cast<double>(pod1.mass_ + pod2.mass_) / static_cast<double>(pod1.mass_ * pod2.mass_);
+template <typename T>
+void PodT<T>::CollidePods(PodT& pod1, PodT& pod2) {
+  Vec2T<T> dp = pod2.position_ - pod1.position_;
+  Vec2T<T> dv = pod2.velocity_ - pod1.velocity_;
+  T m = static_cast<T>(pod1.mass_ + pod2.mass_) / static_cast<T>(pod1.mass_ * pod2.mass_);
 
-  double seperation2 = dp.Length() * dp.Length();
-  double product = Vec2::Dot(dp, dv);
+  T seperation2 = dp.Length() * dp.Length();
+  T product = Vec2T<T>::Dot(dp, dv);
 
-  Vec2 f = dp * (product / (seperation2 * m));
+  Vec2T<T> f = dp * (product / (seperation2 * m));
 
-  pod1.velocity_ += f * (1.0 / pod1.mass_);
-  pod2.velocity_ -= f * (1.0 / pod2.mass_);
+  pod1.velocity_ += f * (T(1.0) / pod1.mass_);
+  pod2.velocity_ -= f * (T(1.0) / pod2.mass_);
 
   float impulse = f.Length();
   if (impulse < 120.0) {
     f *= (120.0 / impulse);
   }
 
-  pod1.velocity_ += f * (1.0 / pod1.mass_);
-  pod2.velocity_ -= f * (1.0 / pod2.mass_);
+  pod1.velocity_ += f * (T(1.0) / pod1.mass_);
+  pod2.velocity_ -= f * (T(1.0) / pod2.mass_);
 }
 
-double Pod::GetFitness(std::vector<Vec2> const& map) const {
+template <typename T>
+double PodT<T>::GetFitness(std::vector<Vec2> const& map, bool partial) const {
   /* Number of checkpoints that need to be hit */
   double max_fitness = (3 * map.size() + 1);
   double fitness = max_fitness;
@@ -126,12 +158,36 @@ double Pod::GetFitness(std::vector<Vec2> const& map) const {
     } else {
       prev_checkpoint = map.size() - 1;
     }
-    // Vec2 segment = map.at(target_checkpoint_) - map.at(prev_checkpoint);
-
-    // Vec2 distance = map.at(target_checkpoint_) - position_;
-
-    // fitness += distance.Length() / segment.Length();
+    if (partial) {
+      /* Short scenarios rarely pass a checkpoint, so also count how much of the leg is left. */
+      Vec2 segment = map.at(target_checkpoint_) - map.at(prev_checkpoint);
+      Vec2 distance = map.at(target_checkpoint_) - Vec2(position_);
+      fitness -= 1.0 - Vec2::Cap(distance.Length() / segment.Length(), 1.0);
+    }
   }
 
   return fitness / max_fitness;
-}
\ No newline at end of file
+}
+
+template <typename T>
+PodState PodT<T>::GetState() const {
+  return PodState{Vec2(position_), Vec2(velocity_), Vec2(direction_), lap_, target_checkpoint_,
+                  shield_cooldown_};
+}
+
+template <typename T>
+void PodT<T>::SetState(PodState const& state) {
+  position_ = Vec2T<T>(state.position);
+  velocity_ = Vec2T<T>(state.velocity);
+  direction_ = Vec2T<T>(state.direction);
+  heading_ = -1;
+  lap_ = state.lap;
+  target_checkpoint_ = state.next_checkpoint;
+  shield_cooldown_ = state.shield_cooldown;
+  mass_ = 1;
+  made_progress_ = false;
+  progress_time_ = 0.0;
+}
+
+template class PodT<double>;
+template class PodT<float>;
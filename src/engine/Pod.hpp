@@ -13,38 +13,79 @@ struct PodControl {
   std::string action;
 };
 
-class Pod {
+/* A command's action as the engine applied it: its thrust, or one of these. */
+enum PodAction : int { kActionNone = -3, kActionBoost = -2, kActionShield = -1 };
+
+/* Everything about a pod that carries over from one turn to the next. */
+struct PodState {
+  Vec2 position;
+  Vec2 velocity;
+  Vec2 direction;
+  int lap;
+  unsigned int next_checkpoint;
+  int shield_cooldown;
+};
+
+/* A pod's physics over a floating point Scalar, see Vec2T. Pod (double) is the referee's;
+ * PodT<float> is explicitly instantiated in Pod.cpp for single-precision simulation. */
+template <typename T>
+class PodT {
  public:
-  void WritePodState(std::ostream& output) const;
+  typedef T Scalar;
+
+  /* Appends the pod's protocol line, "x y vx vy angle next_checkpoint". */
+  void WritePodState(std::string& output) const;
   void SetTurnConditions(PodControl const& control, int& boost_remaining, bool first_frame);
   void EndTurn();
-  void MakeProgress(double dt, unsigned int checkpoint_count);
-  void Advance(double dt);
-  void SetPosition(Vec2 const& origin, Vec2 const& direction, double magnitude);
-  void PointAt(Vec2 const& at);
+  void MakeProgress(T dt, unsigned int checkpoint_count);
+  void Advance(T dt);
+  void SetPosition(Vec2T<T> const& origin, Vec2T<T> const& direction, T magnitude);
+  void PointAt(Vec2T<T> const& at);
 
   bool made_progress() const { return made_progress_; }
-  double progress_time() const { return progress_time_; }
+  T progress_time() const { return progress_time_; }
   bool has_won() const { return lap_ >= 3 && target_checkpoint_ == 1; }
   unsigned int next_checkpoint() const { return target_checkpoint_; }
-  Vec2 const& position() const { return position_; }
-  Vec2 const& velocity() const { return velocity_; }
-  double GetFitness(std::vector<Vec2> const& map) const;
+  int lap() const { return lap_; }
+  int shield_cooldown() const { return shield_cooldown_; }
+  /* The action of the last command, a thrust or a PodAction. */
+  int action() const { return action_; }
+  Vec2T<T> const& position() const { return position_; }
+  Vec2T<T> const& velocity() const { return velocity_; }
+  Vec2T<T> const& direction() const { return direction_; }
+  /* direction().Degrees(), kept until the pod turns: the replay recorder and the next turn's
+   * input then share one atan. */
+  int heading() const {
+    if (heading_ < 0) {
+      heading_ = direction_.Degrees();
+    }
+    return heading_;
+  }
+  double GetFitness(std::vector<Vec2> const& map, bool partial = false) const;
+  PodState GetState() const;
+  void SetState(PodState const& state);
 
-  static void CollidePods(Pod& pod1, Pod& pod2);
+  static void CollidePods(PodT& pod1, PodT& pod2);
 
  private:
   int GetBoost(PodControl const& control, int& boost_remaining);
 
-  Vec2 position_;
-  Vec2 velocity_;
-  Vec2 direction_;
+  Vec2T<T> position_;
+  Vec2T<T> velocity_;
+  Vec2T<T> direction_;
   int lap_ = 0;
   unsigned int target_checkpoint_ = 1;
   int shield_cooldown_ = 0;
   int mass_ = 1;
+  int action_ = kActionNone;
+  mutable int heading_ = -1; /* -1 until heading() computes it */
   bool made_progress_ = false;
-  double progress_time_ = 0.0;
+  T progress_time_ = 0.0;
 };
 
+typedef PodT<double> Pod;
+
+extern template class PodT<double>;
+extern template class PodT<float>;
+
 #endif
\ No newline at end of file
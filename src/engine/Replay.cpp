@@ -0,0 +1,294 @@
+#include "Replay.hpp"
+#include <algorithm>
+#include <cmath>
+#ifdef _WIN32
+#include <io.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace replay;
+
+static int16_t Clamp16(int value) {
+  return static_cast<int16_t>(std::max(-32768, std::min(32767, value)));
+}
+
+/* An existing file is overwritten in place and cut to length by End(): truncating it here would
+ * free its blocks only to allocate them again, which costs more than recording the game. */
+bool ReplayRecorder::Open(std::string const& path) {
+  End();
+  file_ = std::fopen(path.c_str(), "r+b");
+  if (!file_) {
+    file_ = std::fopen(path.c_str(), "wb");
+  }
+  header_ = {};
+  written_ = sizeof(header_);
+  buffer_.clear();
+  keyframes_.clear();
+  return file_ != nullptr;
+}
+
+void ReplayRecorder::Begin(std::vector<Vec2> const& map, std::vector<ReplayPod> const& pods,
+                           std::vector<int> const& timeouts, std::vector<int> const& boosts) {
+  if (!file_) {
+    return;
+  }
+
+  header_ = {};
+  header_.magic = kMagic;
+  header_.version = kVersion;
+  header_.checkpoint_count = std::min<unsigned int>(map.size(), kMaxCheckpoints);
+  for (unsigned int i = 0; i < header_.checkpoint_count; ++i) {
+    header_.checkpoints[i][0] = map[i].x();
+    header_.checkpoints[i][1] = map[i].y();
+  }
+  /* Placeholder, rewritten by End() once the turn count is known. */
+  std::fwrite(&header_, sizeof(header_), 1, file_);
+
+  buffer_.clear();
+  buffer_.reserve(kFlushTurns);
+  keyframes_.clear();
+  previous_.clear();
+  for (auto const& pod : pods) {
+    previous_.push_back({static_cast<int>(pod.pod->position().x()),
+                         static_cast<int>(pod.pod->position().y())});
+  }
+  Append(pods, false, timeouts, boosts);
+}
+
+void ReplayRecorder::Record(std::vector<ReplayPod> const& pods, std::vector<int> const& timeouts,
+                            std::vector<int> const& boosts) {
+  if (file_) {
+    Append(pods, true, timeouts, boosts);
+  }
+}
+
+void ReplayRecorder::Append(std::vector<ReplayPod> const& pods, bool commands,
+                            std::vector<int> const& timeouts, std::vector<int> const& boosts) {
+  /* Positions are whole numbers at the end of every turn. */
+  int positions[kPods][2] = {};
+  for (unsigned int i = 0; i < kPods && i < pods.size(); ++i) {
+    positions[i][0] = static_cast<int>(pods[i].pod->position().x());
+    positions[i][1] = static_cast<int>(pods[i].pod->position().y());
+  }
+  if (header_.turns % kKeyframeInterval == 0) {
+    keyframes_.insert(keyframes_.end(), &positions[0][0], &positions[0][0] + kPods * 2);
+  }
+
+  /* Zeroed in place, so that unset fields and padding are written as zeros. */
+  buffer_.emplace_back();
+  Turn& turn = buffer_.back();
+  for (unsigned int i = 0; i < kPods && i < pods.size(); ++i) {
+    Pod const& pod = *pods[i].pod;
+    PodRecord& r = turn.pods[i];
+    r.dx = Clamp16(positions[i][0] - previous_[i].first);
+    r.dy = Clamp16(positions[i][1] - previous_[i].second);
+    r.vx = Clamp16(static_cast<int>(pod.velocity().x()));
+    r.vy = Clamp16(static_cast<int>(pod.velocity().y()));
+    r.heading = pod.heading();
+    r.next_checkpoint = pod.next_checkpoint();
+    r.lap = pod.lap();
+    r.shield_cooldown = pod.shield_cooldown();
+    r.action = kActionNone;
+
+    if (commands) {
+      r.target_dx = Clamp16(pods[i].target_x - previous_[i].first);
+      r.target_dy = Clamp16(pods[i].target_y - previous_[i].second);
+      r.action = pod.action();
+    }
+    previous_[i] = {positions[i][0], positions[i][1]};
+  }
+  for (unsigned int p = 0; p < 2 && p < timeouts.size(); ++p) {
+    turn.players[p].timeout = timeouts[p];
+    turn.players[p].boosts_available = boosts[p];
+  }
+
+  header_.turns++;
+  if (buffer_.size() >= kFlushTurns) {
+    Flush();
+  }
+}
+
+void ReplayRecorder::Flush() {
+  if (file_ && !buffer_.empty()) {
+    std::fwrite(buffer_.data(), sizeof(Turn), buffer_.size(), file_);
+    written_ += buffer_.size() * sizeof(Turn);
+  }
+  buffer_.clear();
+}
+
+void ReplayRecorder::End() {
+  if (!file_) {
+    return;
+  }
+
+  Flush();
+  /* The header counts turns played; the starting grid is record 0. */
+  header_.keyframe_offset = sizeof(Header) + header_.turns * sizeof(Turn);
+  header_.turns = header_.turns > 0 ? header_.turns - 1 : 0;
+  std::fwrite(keyframes_.data(), sizeof(int32_t), keyframes_.size(), file_);
+  written_ += keyframes_.size() * sizeof(int32_t);
+  std::fseek(file_, 0, SEEK_SET);
+  std::fwrite(&header_, sizeof(header_), 1, file_);
+  /* Drop whatever a longer game left in the file. Fails harmlessly on devices like /dev/null. */
+  std::fflush(file_);
+#ifdef _WIN32
+  _chsize_s(_fileno(file_), written_);
+#else
+  int truncated = ftruncate(fileno(file_), written_);
+  static_cast<void>(truncated);
+#endif
+  std::fclose(file_);
+  file_ = nullptr;
+}
+
+bool ReplayReader::Open(std::string const& path) {
+  Close();
+#ifdef _WIN32
+  HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+  LARGE_INTEGER size;
+  GetFileSizeEx(file, &size);
+  HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (!mapping) {
+    CloseHandle(file);
+    return false;
+  }
+  file_handle_ = file;
+  mapping_handle_ = mapping;
+  data_ = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  size_ = size.QuadPart;
+#else
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat info;
+  if (fstat(fd, &info) != 0 || info.st_size == 0) {
+    close(fd);
+    return false;
+  }
+  void* data = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    return false;
+  }
+  data_ = data;
+  size_ = info.st_size;
+#endif
+  if (!data_ || size_ < sizeof(Header)) {
+    Close();
+    return false;
+  }
+
+  char const* bytes = static_cast<char const*>(data_);
+  header_ = reinterpret_cast<Header const*>(bytes);
+  /* Turns and keyframes must be exactly where the header says, so a truncated or corrupt file is
+   * rejected here rather than read past the mapping. */
+  uint64_t turn_bytes = (static_cast<uint64_t>(header_->turns) + 1) * sizeof(Turn);
+  uint64_t keyframe_bytes =
+      (static_cast<uint64_t>(header_->turns) / kKeyframeInterval + 1) * kPods * 2 * sizeof(int32_t);
+  if (header_->magic != kMagic || header_->version != kVersion ||
+      header_->checkpoint_count > kMaxCheckpoints ||
+      header_->keyframe_offset != sizeof(Header) + turn_bytes ||
+      header_->keyframe_offset + keyframe_bytes > size_) {
+    Close();
+    return false;
+  }
+  turns_ = reinterpret_cast<Turn const*>(bytes + sizeof(Header));
+  keyframes_ = reinterpret_cast<int32_t const*>(bytes + header_->keyframe_offset);
+  return true;
+}
+
+void ReplayReader::Close() {
+#ifdef _WIN32
+  if (data_) {
+    UnmapViewOfFile(data_);
+  }
+  if (mapping_handle_) {
+    CloseHandle(mapping_handle_);
+  }
+  if (file_handle_) {
+    CloseHandle(file_handle_);
+  }
+  mapping_handle_ = nullptr;
+  file_handle_ = nullptr;
+#else
+  if (data_) {
+    munmap(data_, size_);
+  }
+#endif
+  data_ = nullptr;
+  size_ = 0;
+  header_ = nullptr;
+  turns_ = nullptr;
+  keyframes_ = nullptr;
+}
+
+std::vector<Vec2> ReplayReader::map() const {
+  std::vector<Vec2> map;
+  for (unsigned int i = 0; header_ && i < header_->checkpoint_count; ++i) {
+    map.push_back(Vec2(header_->checkpoints[i][0], header_->checkpoints[i][1]));
+  }
+  return map;
+}
+
+bool ReplayReader::Pod(unsigned int turn, unsigned int pod, PodFrame& frame) const {
+  if (!header_ || turn > header_->turns || pod >= kPods) {
+    return false;
+  }
+
+  /* Start from the closest keyframe at or before the turn and add up the deltas. */
+  unsigned int keyframe = turn / kKeyframeInterval;
+  int x = keyframes_[(keyframe * kPods + pod) * 2];
+  int y = keyframes_[(keyframe * kPods + pod) * 2 + 1];
+  for (unsigned int t = keyframe * kKeyframeInterval + 1; t <= turn; ++t) {
+    x += turns_[t].pods[pod].dx;
+    y += turns_[t].pods[pod].dy;
+  }
+
+  PodRecord const& r = turns_[turn].pods[pod];
+  frame.x = x;
+  frame.y = y;
+  frame.vx = r.vx;
+  frame.vy = r.vy;
+  frame.heading = r.heading * Vec2::pi() / 180;
+  frame.next_checkpoint = r.next_checkpoint;
+  frame.lap = r.lap;
+  frame.shield_cooldown = r.shield_cooldown;
+  frame.target_x = x - r.dx + r.target_dx;
+  frame.target_y = y - r.dy + r.target_dy;
+  frame.action = r.action;
+  return true;
+}
+
+bool ReplayReader::ToScenario(unsigned int turn, Scenario& scenario) const {
+  if (!header_ || turn > header_->turns) {
+    return false;
+  }
+  scenario.map = map();
+  scenario.frame = turn;
+  for (unsigned int p = 0; p < 2; ++p) {
+    scenario.players[p].timeout = turns_[turn].players[p].timeout;
+    scenario.players[p].boosts_available = turns_[turn].players[p].boosts_available;
+    for (unsigned int i = 0; i < 2; ++i) {
+      PodFrame frame;
+      Pod(turn, p * 2 + i, frame);
+      PodState& pod = scenario.players[p].pods[i];
+      pod.position = Vec2(frame.x, frame.y);
+      pod.velocity = Vec2(frame.vx, frame.vy);
+      pod.direction = Vec2(std::cos(frame.heading), std::sin(frame.heading));
+      pod.lap = frame.lap;
+      pod.next_checkpoint = frame.next_checkpoint;
+      pod.shield_cooldown = frame.shield_cooldown;
+    }
+  }
+  return true;
+}
@@ -0,0 +1,152 @@
+#ifndef REPLAY_HPP
+#define REPLAY_HPP
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "Pod.hpp"
+#include "Scenario.hpp"
+#include "Vec2.hpp"
+
+/* Replay file layout, all little-endian:
+ *   Header
+ *   Turn[turns + 1]        turn 0 is the starting grid, turn t the state after t turns
+ *   int32 keyframes[][4][2] absolute pod positions of every kKeyframeInterval-th turn
+ * Turns store positions as deltas from the previous turn, so records stay small and fixed width;
+ * the keyframes bound how many deltas a seek has to add up. */
+namespace replay {
+
+static uint32_t constexpr kMagic = 0x59414c50;  // "PLAY"
+static uint32_t constexpr kVersion = 2;
+static unsigned int constexpr kPods = 4;
+static unsigned int constexpr kMaxCheckpoints = 8;
+static unsigned int constexpr kKeyframeInterval = 16;
+
+/* Actions are stored as the engine applied them, see PodAction. */
+using ::kActionBoost;
+using ::kActionNone;
+using ::kActionShield;
+
+struct Header {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t turns;
+  uint32_t checkpoint_count;
+  int32_t checkpoints[kMaxCheckpoints][2];
+  uint64_t keyframe_offset;
+};
+
+struct PodRecord {
+  int16_t dx;
+  int16_t dy;
+  int16_t vx;
+  int16_t vy;
+  uint16_t heading; /* whole degrees, as the protocol reports it */
+  uint8_t next_checkpoint;
+  uint8_t lap;
+  int16_t target_dx; /* command of the turn that led here, relative to the previous position */
+  int16_t target_dy;
+  int16_t action; /* thrust, or one of PodAction */
+  uint8_t shield_cooldown;
+  uint8_t reserved;
+};
+
+struct TeamRecord {
+  uint8_t timeout;
+  uint8_t boosts_available;
+};
+
+struct Turn {
+  PodRecord pods[kPods];
+  TeamRecord players[2];
+};
+
+static_assert(sizeof(Header) == 88, "replay header layout changed");
+static_assert(sizeof(Turn) == 84, "replay turn layout changed");
+
+}  // namespace replay
+
+/* A pod as ReplayRecorder takes it. The recorder reads the pod in place, with the heading the
+ * next turn's input will use and the action as the engine parsed it, so recording a turn copies
+ * no state, parses nothing and adds no trigonometry. */
+struct ReplayPod {
+  Pod const* pod;
+  int target_x; /* command of the turn that led here */
+  int target_y;
+};
+
+/* Writes one game to a file. Turns are buffered in memory and written in large blocks; the
+ * keyframe index and turn count are written by End(). */
+class ReplayRecorder {
+ public:
+  ~ReplayRecorder() { End(); }
+
+  bool Open(std::string const& path);
+  /* The starting grid: commands are ignored. */
+  void Begin(std::vector<Vec2> const& map, std::vector<ReplayPod> const& pods,
+             std::vector<int> const& timeouts, std::vector<int> const& boosts);
+  void Record(std::vector<ReplayPod> const& pods, std::vector<int> const& timeouts,
+              std::vector<int> const& boosts);
+  void End();
+
+ private:
+  static unsigned int constexpr kFlushTurns = 128;
+
+  void Append(std::vector<ReplayPod> const& pods, bool commands, std::vector<int> const& timeouts,
+              std::vector<int> const& boosts);
+  void Flush();
+
+  std::FILE* file_ = nullptr;
+  uint64_t written_ = 0;
+  replay::Header header_ = {};
+  std::vector<replay::Turn> buffer_;
+  std::vector<int32_t> keyframes_;
+  std::vector<std::pair<int, int>> previous_;
+};
+
+/* Memory-maps a replay file and decodes turns in place. Open() rejects files whose header does
+ * not match their size, and the accessors reject turns and pods outside the game. */
+class ReplayReader {
+ public:
+  struct PodFrame {
+    int x;
+    int y;
+    int vx;
+    int vy;
+    double heading; /* radians */
+    unsigned int next_checkpoint;
+    int lap;
+    int shield_cooldown;
+    int target_x;
+    int target_y;
+    int action;
+  };
+
+  ReplayReader() {}
+  ReplayReader(ReplayReader const&) = delete;
+  ReplayReader& operator=(ReplayReader const&) = delete;
+  ~ReplayReader() { Close(); }
+
+  bool Open(std::string const& path);
+  void Close();
+
+  unsigned int turns() const { return header_ ? header_->turns : 0; }
+  std::vector<Vec2> map() const;
+  /* Turns run from 0, the starting grid, to turns(). */
+  bool Pod(unsigned int turn, unsigned int pod, PodFrame& frame) const;
+  bool ToScenario(unsigned int turn, Scenario& scenario) const;
+
+ private:
+  replay::Header const* header_ = nullptr;
+  replay::Turn const* turns_ = nullptr;
+  int32_t const* keyframes_ = nullptr;
+  void* data_ = nullptr;
+  size_t size_ = 0;
+#ifdef _WIN32
+  void* file_handle_ = nullptr;
+  void* mapping_handle_ = nullptr;
+#endif
+};
+
+#endif
@@ -0,0 +1,98 @@
+#include "Scenario.hpp"
+#include <algorithm>
+#include <fstream>
+
+bool ScenarioLibrary::Save(std::string const& path) const {
+  std::ofstream file(path, std::ios::binary);
+  uint32_t count = scenarios_.size();
+  file.write(reinterpret_cast<char const*>(&kMagic), sizeof(kMagic));
+  file.write(reinterpret_cast<char const*>(&kVersion), sizeof(kVersion));
+  file.write(reinterpret_cast<char const*>(&count), sizeof(count));
+  for (auto const& scenario : scenarios_) {
+    Record record = Encode(scenario);
+    file.write(reinterpret_cast<char const*>(&record), sizeof(record));
+  }
+  return static_cast<bool>(file);
+}
+
+bool ScenarioLibrary::Load(std::string const& path) {
+  std::ifstream file(path, std::ios::binary);
+  uint32_t magic = 0;
+  uint32_t version = 0;
+  uint32_t count = 0;
+  file.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+  file.read(reinterpret_cast<char*>(&version), sizeof(version));
+  file.read(reinterpret_cast<char*>(&count), sizeof(count));
+  if (!file || magic != kMagic || version != kVersion) {
+    return false;
+  }
+
+  std::vector<Record> records(count);
+  file.read(reinterpret_cast<char*>(records.data()), count * sizeof(Record));
+  if (!file) {
+    return false;
+  }
+
+  for (auto const& record : records) {
+    scenarios_.push_back(Decode(record));
+  }
+  return true;
+}
+
+ScenarioLibrary::Record ScenarioLibrary::Encode(Scenario const& scenario) {
+  Record record = {};
+  record.checkpoint_count = std::min<unsigned int>(scenario.map.size(), kMaxCheckpoints);
+  record.frame = scenario.frame;
+  for (unsigned int i = 0; i < record.checkpoint_count; ++i) {
+    record.checkpoints[i][0] = scenario.map[i].x();
+    record.checkpoints[i][1] = scenario.map[i].y();
+  }
+
+  for (unsigned int p = 0; p < 2; ++p) {
+    Scenario::Team const& team = scenario.players[p];
+    TeamRecord& out = record.players[p];
+    out.timeout = team.timeout;
+    out.boosts_available = team.boosts_available;
+    for (unsigned int i = 0; i < 2; ++i) {
+      PodState const& pod = team.pods[i];
+      PodRecord& r = out.pods[i];
+      /* Positions are rounded and velocities truncated at the end of every turn. */
+      r.x = pod.position.x();
+      r.y = pod.position.y();
+      r.vx = pod.velocity.x();
+      r.vy = pod.velocity.y();
+      r.direction_x = pod.direction.x();
+      r.direction_y = pod.direction.y();
+      r.lap = pod.lap;
+      r.next_checkpoint = pod.next_checkpoint;
+      r.shield_cooldown = pod.shield_cooldown;
+    }
+  }
+  return record;
+}
+
+Scenario ScenarioLibrary::Decode(Record const& record) {
+  Scenario scenario;
+  scenario.frame = record.frame;
+  for (unsigned int i = 0; i < record.checkpoint_count; ++i) {
+    scenario.map.push_back(Vec2(record.checkpoints[i][0], record.checkpoints[i][1]));
+  }
+
+  for (unsigned int p = 0; p < 2; ++p) {
+    TeamRecord const& in = record.players[p];
+    Scenario::Team& team = scenario.players[p];
+    team.timeout = in.timeout;
+    team.boosts_available = in.boosts_available;
+    for (unsigned int i = 0; i < 2; ++i) {
+      PodRecord const& r = in.pods[i];
+      PodState& pod = team.pods[i];
+      pod.position = Vec2(r.x, r.y);
+      pod.velocity = Vec2(r.vx, r.vy);
+      pod.direction = Vec2(r.direction_x, r.direction_y);
+      pod.lap = r.lap;
+      pod.next_checkpoint = r.next_checkpoint;
+      pod.shield_cooldown = r.shield_cooldown;
+    }
+  }
+  return scenario;
+}
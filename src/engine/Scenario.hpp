@@ -0,0 +1,74 @@
+#ifndef SCENARIO_HPP
+#define SCENARIO_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Pod.hpp"
+#include "Vec2.hpp"
+
+/* A mid-race game state that GameController can resume from. */
+struct Scenario {
+  struct Team {
+    PodState pods[2];
+    int timeout;
+    int boosts_available;
+  };
+
+  std::vector<Vec2> map;
+  int frame;
+  Team players[2];
+};
+
+/* Scenarios stored as fixed-width little-endian records, so any one of them can be read without
+ * parsing the ones before it. */
+class ScenarioLibrary {
+ public:
+  static unsigned int constexpr kMaxCheckpoints = 8;
+
+  void Add(Scenario const& scenario) { scenarios_.push_back(scenario); }
+  Scenario const& operator[](unsigned int index) const { return scenarios_.at(index); }
+  unsigned int size() const { return scenarios_.size(); }
+
+  bool Save(std::string const& path) const;
+  bool Load(std::string const& path);
+
+ private:
+  static uint32_t constexpr kMagic = 0x534e4552;  // "RENS"
+  static uint32_t constexpr kVersion = 2;
+
+  /* Headings are kept at full precision so that a loaded scenario resumes exactly. */
+  struct PodRecord {
+    double direction_x;
+    double direction_y;
+    int32_t x;
+    int32_t y;
+    int16_t vx;
+    int16_t vy;
+    uint8_t lap;
+    uint8_t next_checkpoint;
+    uint8_t shield_cooldown;
+    uint8_t reserved;
+  };
+  struct TeamRecord {
+    PodRecord pods[2];
+    uint8_t timeout;
+    uint8_t boosts_available;
+    uint8_t reserved[6];
+  };
+  struct Record {
+    uint8_t checkpoint_count;
+    uint8_t reserved[5];
+    uint16_t frame;
+    int16_t checkpoints[kMaxCheckpoints][2];
+    TeamRecord players[2];
+  };
+  static_assert(sizeof(Record) == 184, "scenario record layout changed");
+
+  static Record Encode(Scenario const& scenario);
+  static Scenario Decode(Record const& record);
+
+  std::vector<Scenario> scenarios_;
+};
+
+#endif
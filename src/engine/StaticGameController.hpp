@@ -0,0 +1,478 @@
+#ifndef STATICGAMECONTROLLER_HPP
+#define STATICGAMECONTROLLER_HPP
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include "GameServer.hpp"
+#include "LatencyHistogram.hpp"
+#include "IPlayer.hpp"
+#include "PerfCounters.hpp"
+#include "Pod.hpp"
+#include "Scenario.hpp"
+#include "Stats.hpp"
+#include "TextProtocol.hpp"
+#include "Vec2.hpp"
+
+/* GameController's full-fidelity RunGame for a fixed set of controller types: players and pods
+ * live in std::arrays, controllers are called without virtual dispatch, and every pod loop has a
+ * compile-time bound. Plays the same game as GameController for the same rand() state. Use
+ * GameController for anything else: mixed or runtime-chosen bots, screening, early termination,
+ * replays or deadlines. */
+template <unsigned int kPodsPerPlayer, typename... Controllers>
+class StaticGameController {
+ public:
+  static unsigned int constexpr kPlayers = sizeof...(Controllers);
+  static unsigned int constexpr kPods = kPlayers * kPodsPerPlayer;
+
+  StaticGameController(Controllers&... controllers) : controllers_(controllers...) {
+    SetStreams(Indices());
+  }
+
+  // Return winning player (0 or 1)
+  int RunGame();
+
+  /* Ready for another RunGame with the same controllers, as GameController::Reset. */
+  void Reset();
+
+  double GetFitness(unsigned int player) const;
+
+  /* GameController::RunScenario and CaptureScenario, for two players of two pods; the
+   * conformance check plays its fuzzed states through them. */
+  int RunScenario(Scenario const& scenario, unsigned int horizon);
+  Scenario CaptureScenario() const;
+
+  /* Wall time of each controller's Setup and Turn calls, as Player keeps them. */
+  LatencyHistogram const& setup_latency(unsigned int player) const {
+    return players_.at(player).setup_latency;
+  }
+  LatencyHistogram const& turn_latency(unsigned int player) const {
+    return players_.at(player).turn_latency;
+  }
+
+ private:
+  typedef std::make_index_sequence<kPlayers> Indices;
+
+  struct PlayerState {
+    std::istringstream input;
+    std::ostringstream output;
+    int timeout = 100;
+    int boosts_available = 1;
+    bool has_won = false;
+    double win_time = 1.0;
+    bool has_lost = false;
+    LatencyHistogram setup_latency;
+    LatencyHistogram turn_latency;
+  };
+
+  template <size_t... I>
+  void SetStreams(std::index_sequence<I...>);
+  template <size_t... I>
+  void Setup(std::index_sequence<I...>);
+  template <size_t I>
+  void SetupController();
+  template <size_t... I>
+  void ResetControllers(std::index_sequence<I...>);
+  template <size_t... I>
+  void ResumeControllers(std::array<RaceProgress, kPlayers> const& progress,
+                         std::index_sequence<I...>);
+  template <size_t... I>
+  void Commands(std::array<std::string, kPlayers> const& inputs, std::index_sequence<I...>);
+  template <size_t I>
+  void Command(std::string const& input);
+
+  void InitPods();
+  int Turn();
+  double ResolveCollisions();
+  void EndTurn(unsigned int player);
+  int GetWinner() const;
+
+  std::tuple<Controllers&...> controllers_;
+  std::array<PlayerState, kPlayers> players_;
+  /* Player p's pods are p * kPodsPerPlayer onwards, GameController's order. */
+  std::array<Pod, kPods> pods_;
+  std::vector<Vec2> map_;
+  int frame_count_ = 0;
+};
+
+template <unsigned int kPodsPerPlayer, typename... Controllers>
+int StaticGameController<kPodsPerPlayer, Controllers...>::RunGame() {
+  GameController::RandomMap(map_);
+  std::string map_input = GameController::MapInput(map_);
+  for (PlayerState& player : players_) {
+    player.input.clear();
+    player.input.str(map_input);
+  }
+  Setup(Indices());
+  InitPods();
+  GameController::termination_report().games++;
+
+  while (true) {
+    int winner = Turn();
+    if (winner != -1) {
+      STATS_COUNT(kGames, 1);
+      STATS_HISTOGRAM(kGameLength, frame_count_);
+      return winner;
+    }
+  }
+}
+
+template <unsigned int kPodsPerPlayer, typename... Controllers>
+void StaticGameController<kPodsPerPlayer, Controllers...>::Reset() {
+  for (PlayerState& player : players_) {
+    player.timeout = 100;
+    player.boosts_available = 1;
+    player.has_won = false;
+    player.win_time = 1.0;
+    player.has_lost = false;
+  }
+  pods_.fill(Pod());
+  map_.clear();
+  frame_count_ = 0;
+  ResetControllers(Indices());
+}
+
+template <unsigned int kPodsPerPlayer, typename... Controllers>
+double StaticGameController<kPodsPerPlayer, Controllers...>::GetFitness(unsigned int player) const {
+  double fitness = pods_[player * kPodsPerPlayer].GetFitness(map_);
+  for (unsigned int k = 1; k < kPodsPerPlayer; ++k) {
+    fitness = std::min(fitness, pods_[player * kPodsPerPlayer + k].GetFitness(map_));
+  }
+  return fitness;
+}
+
+template <unsigned int kPodsPerPlayer, typename... Controllers>
+int StaticGameController<kPodsPerPlayer, Controllers...>::RunScenario(Scenario const& scenario,
+                                                                      unsigned int horizon) {
+  static_assert(kPlayers == 2 && kPodsPerPlayer == 2, "scenarios hold two players of two pods");
+  map_ = scenario.map;
+  std::string map_input = GameController::MapInput(map_);
+  for (PlayerState& player : players_) {
+    player.input.clear();
+    player.input.str(map_input);
+  }
+  Setup(Indices());
+
+  std::array<RaceProgress, kPlayers> progress;
+  for (unsigned int p = 0; p < kPlayers; ++p) {
+    Scenario::Team const& team = scenario.players[p];
+    PlayerState& player = players_[p];
+    player.timeout = team.timeout;
+    player.boosts_available = team.boosts_available;
+    player.has_won = false;
+    player.win_time = 1.0;
+    player.has_lost = false;
+    for (unsigned int k = 0; k < kPodsPerPlayer; ++k) {
+      pods_[p * kPodsPerPlayer + k].SetState(team.pods[k]);
+    }
+    for (unsigned int j = 0; j < kPods; ++j) {
+      PodState const& pod = scenario.players[j < 2 ? p : 1 - p].pods[j % 2];
+      progress[p].laps[j] = pod.lap;
+      progress[p].next_checkpoints[j] = pod.next_checkpoint;
+    }
+    progress[p].boosts_available = team.boosts_available;
+  }
+  ResumeControllers(progress, Indices());
+
+  frame_count_ = std::max(scenario.frame, 1);
+  for (unsigned int t = 0; t < horizon; ++t) {
+    int winner = Turn();
+    if (winner != -1) {
+      return winner;
+    }
+  }
+  return -1;
+}
+
+template <unsigned int kPodsPerPlayer, typename... Controllers>
+Scenario StaticGameController<kPodsPerPlayer, Controllers...>::CaptureScenario() const {
+  Scenario scenario;
+  scenario.map = map_;
+  scenario.frame = frame_count_;
+  for (unsigned int p = 0; p < kPlayers; ++p) {
+    Scenario::Team& team = scenario.players[p];
+    for (unsigned int k = 0; k < kPodsPerPlayer; ++k) {
+      team.pods[k] = pods_[p * kPodsPerPlayer + k].GetState();
+    }
+    team.timeout = players_[p].timeout;
+    team.boosts_available = players_[p].boosts_available;
+  }
+  return scenario;
+}
+
+template <unsigned int kPodsPerPlayer, typename... Controllers>
+template <size_t... I>
+void StaticGameController<kPodsPerPlayer, Controllers...>::SetStreams(std::index_sequence<I...>) {
+  (std::get<I>(controllers_).SetStreams(players_[I].input, players_[I].output), ...);
+}
+
+/* Qualified calls, so the compiler sees the exact function and can inline it. */
+template <unsigned int kPodsPerPlayer, typename... Controllers>
+template <size_t... I>
+void StaticGameController<kPodsPerPlayer, Controllers...>::Setup(std::index_sequence<I...>) {
+  (SetupController<I>(), ...);
+}
+
+template <unsigned int kPodsPerPlayer, typename... Controllers>
+template <size_t I>
+void StaticGameController<kPodsPerPlayer, Controllers...>::SetupController() {
+  typedef typename std::tuple_element<I, std::tuple<Controllers...>>::type Controller;
+  auto start = std::chrono::steady_clock::now();
+  std::get<I>(controllers_).Controller::Setup();
+  players_[I].setup_latency.Add(LatencyHistogram::Since(start));
+}
+
+template <unsigned int kPodsPerPlayer, typename... Controllers>
+template <size_t... I>
+void StaticGameController<kPodsPerPlayer, Controllers...>::ResetControllers(
+    std::index_sequence<I...>) {
+  (std::get<I>(controllers_).Controllers::Reset(), ...);
+}
+
+template <unsigned int kPodsPerPlayer, typename... Controllers>
+template <size_t... I>
+void StaticGameController<kPodsPerPlayer, Controllers...>::ResumeControllers(
+    std::array<RaceProgress, kPlayers> const& progress, std::index_sequence<I...>) {
+  (std::get<I>(controllers_).Controllers::Resume(progress[I]), ...);
+}
+
+template <unsigned int kPodsPerPlayer, typename... Controllers>
+template <size_t... I>
+void StaticGameController<kPodsPerPlayer, Controllers...>::Commands(
+    std::array<std::string, kPlayers> const& inputs, std::index_sequence<I...>) {
+  (Command<I>(inputs[I]), ...);
+}
+
+template <unsigned int kPodsPerPlayer, typename... Controllers>
+template <size_t I>
+void StaticGameController<kPodsPerPlayer, Controllers...>::Command(std::string const& input) {
+  typedef typename std::tuple_element<I, std::tuple<Controllers...>>::type Controller;
+  PlayerState& player = players_[I];
+  player.input.clear();
+  player.output.str("");
+  player.output.clear();
+  player.input.str(input);
+  auto start = std::chrono::steady_clock::now();
+  std::get<I>(controllers_).Controller::Turn();
+  player.turn_latency.Add(LatencyHistogram::Since(start));
+
+  std::string const actions = player.output.str();
+  char const* in = actions.data();
+  char const* end = in + actions.size();
+  for (unsigned int k = 0; k < kPodsPerPlayer; ++k) {
+    PodControl control;
+    protocol::ParseCommand(in, end, control.x, control.y, control.action);
+    pods_[I * kPodsPerPlayer + k].SetTurnConditions(control, player.boosts_available,
+                                                    frame_count_ == 0);
+  }
+}
+
+/* GameController::InitPods: one lane each, inside lane drawn at random, pods either side of the
+ * first checkpoint on the line across the first leg. */
+template <unsigned int kPodsPerPlayer, typename... Controllers>
+void StaticGameController<kPodsPerPlayer, Controllers...>::InitPods() {
+  static double constexpr kSeperation = 1000.0;
+
+  Vec2 initial_direction = map_[1] - map_[0];
+  Vec2 placement_line = Vec2::Perpendicular(initial_direction);
+  placement_line.Normalize();
+
+  unsigned int inside = rand() % 2 == 0 ? 0 : 1;
+  for (unsigned int p = 0; p < kPlayers; ++p) {
+    for (unsigned int k = 0; k < kPodsPerPlayer; ++k) {
+      unsigned int lane = (p + inside) % kPlayers + k / 2 * kPlayers;
+      double seperation = kSeperation / 2 + lane * kSeperation;
+      Pod& pod = pods_[p * kPodsPerPlayer + k];
+      pod.SetPosition(map_[0], placement_line, k % 2 == 0 ? seperation : -seperation);
+      pod.PointAt(map_[1]);
+    }
+  }
+}
+
+template <unsigned int kPodsPerPlayer, typename... Controllers>
+int StaticGameController<kPodsPerPlayer, Controllers...>::Turn() {
+  PERF_REGION(kRegionTurn);
+  STATS_COUNT(kTurns, 1);
+  STATS_PHASE(kPhaseInput);
+  /* Each player sees its own pods first, then everybody else's in player order. */
+  std::array<std::string, kPlayers> player_data;
+  for (unsigned int i = 0; i < kPods; ++i) {
+    pods_[i].WritePodState(player_data[i / kPodsPerPlayer]);
+  }
+  std::array<std::string, kPlayers> inputs;
+  for (unsigned int p = 0; p < kPlayers; ++p) {
+    inputs[p] = player_data[p];
+    for (unsigned int q = 0; q < kPlayers; ++q) {
+      if (q != p) {
+        inputs[p] += player_data[q];
+      }
+    }
+  }
+  Commands(inputs, Indices());
+
+  STATS_NEXT_PHASE(kPhaseCollisions);
+  double turn_time_remaining = ResolveCollisions();
+
+  STATS_NEXT_PHASE(kPhaseEndTurn);
+  for (Pod& pod : pods_) {
+    pod.Advance(turn_time_remaining);
+  }
+  for (unsigned int p = 0; p < kPlayers; ++p) {
+    EndTurn(p);
+  }
+
+  frame_count_++;
+  return GetWinner();
+}
+
+/* GameController::ResolveCollisions: earliest event first, lowest pod (pair) index on ties. */
+template <unsigned int kPodsPerPlayer, typename... Controllers>
+double StaticGameController<kPodsPerPlayer, Controllers...>::ResolveCollisions() {
+  double turn_time_remaining = 1.0;
+  unsigned int t = 0;
+  for (; t < 1000; ++t) {
+    double dt_checkpoint = 2.0;
+    Pod* pod_checkpoint = nullptr;
+    for (unsigned int i = 0; i < kPods; ++i) {
+      double time;
+      Pod const& pod = pods_[i];
+      Vec2 const& checkpoint = map_[pod.next_checkpoint()];
+      if (GameController::MayCollide(pod.position(), pod.velocity(), 0, checkpoint, Vec2(), 600,
+                                     turn_time_remaining) &&
+          GameController::GetNextCollision(pod.position(), pod.velocity(), 0, checkpoint, Vec2(),
+                                           600, time) &&
+          time < 1.0 && time < dt_checkpoint) {
+        dt_checkpoint = time;
+        pod_checkpoint = &pods_[i];
+      }
+    }
+
+    double dt_pod = 2.0;
+    Pod* pod_collision_1 = nullptr;
+    Pod* pod_collision_2 = nullptr;
+    for (unsigned int i = 0; i + 1 < kPods; ++i) {
+      for (unsigned int j = i + 1; j < kPods; ++j) {
+        double time;
+        if (GameController::MayCollide(pods_[i].position(), pods_[i].velocity(), 400,
+                                       pods_[j].position(), pods_[j].velocity(), 400,
+                                       turn_time_remaining) &&
+            GameController::GetNextCollision(pods_[i].position(), pods_[i].velocity(), 400,
+                                             pods_[j].position(), pods_[j].velocity(), 400,
+                                             time) &&
+            time < 1.0 && time < dt_pod) {
+          dt_pod = time;
+          pod_collision_1 = &pods_[i];
+          pod_collision_2 = &pods_[j];
+        }
+      }
+    }
+
+    bool checkpoint_collision = pod_checkpoint != nullptr;
+    bool pod_collision = pod_collision_1 != nullptr;
+    if (checkpoint_collision && pod_collision) {
+      if (dt_checkpoint < dt_pod) {
+        pod_collision = false;
+      } else {
+        checkpoint_collision = false;
+      }
+    }
+
+    if (checkpoint_collision && dt_checkpoint <= turn_time_remaining) {
+      for (Pod& pod : pods_) {
+        pod.Advance(dt_checkpoint);
+      }
+      turn_time_remaining -= dt_checkpoint;
+      pod_checkpoint->MakeProgress(dt_checkpoint, map_.size());
+      STATS_COUNT(kCheckpointCollisions, 1);
+      continue;
+    }
+
+    if (pod_collision && dt_pod <= turn_time_remaining) {
+      for (Pod& pod : pods_) {
+        pod.Advance(dt_pod);
+      }
+      turn_time_remaining -= dt_pod;
+      Pod::CollidePods(*pod_collision_1, *pod_collision_2);
+      STATS_COUNT(kPodCollisions, 1);
+      continue;
+    }
+
+    break;
+  }
+
+  STATS_COUNT(kSubSteps, t);
+  STATS_COUNT(kSubStepCapHits, t == 1000);
+  STATS_HISTOGRAM(kSubStepsPerTurn, t);
+  return turn_time_remaining;
+}
+
+/* Player::EndTurn. */
+template <unsigned int kPodsPerPlayer, typename... Controllers>
+void StaticGameController<kPodsPerPlayer, Controllers...>::EndTurn(unsigned int index) {
+  PlayerState& player = players_[index];
+  bool progress = false;
+  for (unsigned int k = 0; k < kPodsPerPlayer; ++k) {
+    Pod& pod = pods_[index * kPodsPerPlayer + k];
+    if (pod.made_progress()) {
+      progress = true;
+      if (pod.has_won() && !player.has_lost) {
+        player.has_won = true;
+        player.win_time = pod.progress_time();
+      }
+    }
+    pod.EndTurn();
+  }
+
+  if (progress) {
+    player.timeout = 100;
+  } else {
+    if (player.timeout > 0) {
+      player.timeout--;
+    } else {
+      player.has_lost = true;
+    }
+  }
+}
+
+/* GameController::GetWinner. */
+template <unsigned int kPodsPerPlayer, typename... Controllers>
+int StaticGameController<kPodsPerPlayer, Controllers...>::GetWinner() const {
+  unsigned int lost_players = 0;
+  double win_time = 2.0;
+  int win_player = -1;
+  for (unsigned int i = 0; i < kPlayers; ++i) {
+    if (players_[i].has_won && players_[i].win_time < win_time) {
+      win_time = players_[i].win_time;
+      win_player = i;
+    }
+
+    if (players_[i].has_lost) {
+      lost_players++;
+    }
+  }
+
+  if (win_player != -1) {
+    return win_player;
+  }
+
+  if (lost_players >= kPlayers - 1) {
+    for (unsigned int i = 0; i < kPlayers; ++i) {
+      if (!players_[i].has_lost) {
+        return i;
+      }
+    }
+  }
+  if (lost_players == 2) {
+    return -2;
+  }
+
+  return -1;
+}
+
+#endif
@@ -0,0 +1,110 @@
+#include "Stats.hpp"
+#include <algorithm>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace stats {
+
+static char const* const kCounterNames[kCounterCount] = {
+    "games",                 "turns",          "sub_steps",         "sub_step_cap_hits",
+    "checkpoint_collisions", "pod_collisions", "broad_phase_tests", "broad_phase_rejects"};
+static char const* const kHistogramNames[kHistogramCount] = {"sub_steps_per_turn", "game_length"};
+static char const* const kPhaseNames[kPhaseCount] = {"input", "collisions", "end_turn"};
+
+/* Blocks of running threads, and the sum of those that have exited. */
+static std::mutex registry_mutex;
+static std::vector<std::unique_ptr<ThreadStats>> registry;
+static ThreadStats retired = {};
+static unsigned long retired_threads = 0;
+
+static void Add(ThreadStats& total, ThreadStats const& local) {
+  for (unsigned int i = 0; i < kCounterCount; ++i) {
+    total.counters[i] += local.counters[i];
+  }
+  for (unsigned int h = 0; h < kHistogramCount; ++h) {
+    for (unsigned int b = 0; b < kBuckets; ++b) {
+      total.histograms[h][b] += local.histograms[h][b];
+    }
+  }
+  for (unsigned int p = 0; p < kPhaseCount; ++p) {
+    total.phase_ns[p] += local.phase_ns[p];
+  }
+}
+
+ThreadStats* Register() {
+  std::lock_guard<std::mutex> lock(registry_mutex);
+  registry.emplace_back(new ThreadStats());
+  return registry.back().get();
+}
+
+void Retire(ThreadStats* local) {
+  std::lock_guard<std::mutex> lock(registry_mutex);
+  Add(retired, *local);
+  retired_threads++;
+  registry.erase(std::find_if(registry.begin(), registry.end(),
+                              [local](std::unique_ptr<ThreadStats> const& entry) {
+                                return entry.get() == local;
+                              }));
+}
+
+/* Leaves the stream's formatting as it found it, for callers that print between reports. */
+void Print(std::ostream& output) {
+  std::lock_guard<std::mutex> lock(registry_mutex);
+  ThreadStats total = retired;
+  for (auto const& local : registry) {
+    Add(total, *local);
+  }
+
+  std::ios::fmtflags flags = output.flags();
+  std::streamsize precision = output.precision();
+  double turns = total.counters[kTurns] > 0 ? total.counters[kTurns] : 1;
+  output << "stats: " << registry.size() + retired_threads << " threads" << std::endl;
+  for (unsigned int i = 0; i < kCounterCount; ++i) {
+    output << "  " << std::left << std::setw(24) << kCounterNames[i] << std::right
+           << std::setw(14) << total.counters[i] << std::setw(12) << std::fixed
+           << std::setprecision(4) << total.counters[i] / turns << " /turn" << std::endl;
+  }
+  if (total.counters[kBroadPhaseTests] > 0) {
+    output << "  broad phase rejection rate " << std::setprecision(4)
+           << static_cast<double>(total.counters[kBroadPhaseRejects]) /
+                  total.counters[kBroadPhaseTests]
+           << std::endl;
+  }
+  for (unsigned int p = 0; p < kPhaseCount; ++p) {
+    output << "  phase " << std::left << std::setw(18) << kPhaseNames[p] << std::right
+           << std::setw(14) << std::setprecision(1) << total.phase_ns[p] / 1e6 << " ms"
+           << std::setw(12) << total.phase_ns[p] / turns << " ns/turn" << std::endl;
+  }
+  for (unsigned int h = 0; h < kHistogramCount; ++h) {
+    output << "  " << kHistogramNames[h] << std::endl;
+    for (unsigned int b = 0; b < kBuckets; ++b) {
+      if (total.histograms[h][b] == 0) {
+        continue;
+      }
+      uint64_t low = b == 0 ? 0 : uint64_t(1) << (b - 1);
+      uint64_t high = (uint64_t(1) << b) - 1;
+      std::string range = std::to_string(low);
+      if (b == kBuckets - 1) {
+        range += "+";
+      } else if (high > low) {
+        range += "-" + std::to_string(high);
+      }
+      output << "    " << std::left << std::setw(20) << range << std::right << std::setw(14)
+             << total.histograms[h][b] << std::endl;
+    }
+  }
+  output.flags(flags);
+  output.precision(precision);
+}
+
+#ifdef PODRACING_STATS
+/* Destroyed after the main thread's block is retired and before the registry above. */
+static struct PrintAtExit {
+  ~PrintAtExit() { Print(std::cerr); }
+} print_at_exit;
+#endif
+
+}  // namespace stats
@@ -0,0 +1,112 @@
+#ifndef STATS_HPP
+#define STATS_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+
+/* Simulation loop counters, compiled in with -DPODRACING_STATS (make STATS=1) and printed to stderr
+ * at exit, or whenever STATS_PRINT is reached. Every thread writes its own cache-line aligned
+ * block, so evaluation threads never share a line; blocks are only summed when printed, and a
+ * thread's block is folded into the totals when it exits. Without the define the macros expand to
+ * nothing. */
+namespace stats {
+
+enum Counter {
+  kGames,
+  kTurns,
+  kSubSteps,
+  kSubStepCapHits,
+  kCheckpointCollisions,
+  kPodCollisions,
+  kBroadPhaseTests,   /* Pod-pair and pod-checkpoint pre-tests before a collision solve. */
+  kBroadPhaseRejects, /* Pre-tests that skipped the solve. */
+
+  kCounterCount
+};
+
+enum Histogram {
+  kSubStepsPerTurn,
+  kGameLength,
+
+  kHistogramCount
+};
+
+enum Phase {
+  kPhaseInput,      /* Game state out, controller commands in. */
+  kPhaseCollisions, /* Sub-step collision resolution. */
+  kPhaseEndTurn,    /* Final advance, friction, rounding and the winner check. */
+
+  kPhaseCount
+};
+
+/* Bucket 0 holds 0, bucket b holds [2^(b-1), 2^b), the last bucket everything above. */
+static unsigned int constexpr kBuckets = 16;
+
+struct alignas(64) ThreadStats {
+  uint64_t counters[kCounterCount];
+  uint64_t histograms[kHistogramCount][kBuckets];
+  uint64_t phase_ns[kPhaseCount];
+};
+
+ThreadStats* Register();
+/* Adds the block to the totals of exited threads and frees it. */
+void Retire(ThreadStats* local);
+void Print(std::ostream& output);
+
+struct LocalStats {
+  ThreadStats* stats = Register();
+  ~LocalStats() { Retire(stats); }
+};
+
+inline ThreadStats& Local() {
+  thread_local LocalStats local;
+  return *local.stats;
+}
+
+inline unsigned int Bucket(uint64_t value) {
+  unsigned int bucket = 0;
+  while (value > 0 && bucket < kBuckets - 1) {
+    value >>= 1;
+    bucket++;
+  }
+  return bucket;
+}
+
+/* Charges the time since construction, or since the last Next(), to the current phase. */
+class PhaseTimer {
+ public:
+  PhaseTimer(Phase phase) : phase_(phase), start_(std::chrono::steady_clock::now()) {}
+  ~PhaseTimer() { Next(phase_); }
+
+  void Next(Phase phase) {
+    auto now = std::chrono::steady_clock::now();
+    Local().phase_ns[phase_] +=
+        std::chrono::duration_cast<std::chrono::nanoseconds>(now - start_).count();
+    phase_ = phase;
+    start_ = now;
+  }
+
+ private:
+  Phase phase_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+}  // namespace stats
+
+#ifdef PODRACING_STATS
+#define STATS_COUNT(counter, n) (stats::Local().counters[stats::counter] += (n))
+#define STATS_HISTOGRAM(histogram, value) \
+  (stats::Local().histograms[stats::histogram][stats::Bucket(value)]++)
+#define STATS_PHASE(phase) stats::PhaseTimer stats_timer(stats::phase)
+#define STATS_NEXT_PHASE(phase) stats_timer.Next(stats::phase)
+#define STATS_PRINT(output) stats::Print(output)
+#else
+#define STATS_COUNT(counter, n) ((void)0)
+#define STATS_HISTOGRAM(histogram, value) ((void)0)
+#define STATS_PHASE(phase) ((void)0)
+#define STATS_NEXT_PHASE(phase) ((void)0)
+#define STATS_PRINT(output) ((void)0)
+#endif
+
+#endif
@@ -0,0 +1,126 @@
+#ifndef TEXTPROTOCOL_HPP
+#define TEXTPROTOCOL_HPP
+
+#include <initializer_list>
+#include <istream>
+#include <limits>
+#include <string>
+
+/* The game's text protocol without iostream formatting: integers are written and read by hand
+ * over contiguous char buffers, in the manner of std::to_chars and std::from_chars. Text is the
+ * same as operator<< gives, and ends lines with '\n' where the protocol used std::endl. Both the
+ * engine and the controllers' GameIO use it. */
+namespace protocol {
+
+/* Enough for any long long, sign included. */
+static unsigned int constexpr kMaxIntChars = 20;
+
+/* Writes value in decimal at out, returning one past the last char written. */
+inline char* FormatInt(char* out, long long value) {
+  unsigned long long magnitude = value;
+  if (value < 0) {
+    *out++ = '-';
+    magnitude = 0 - magnitude;
+  }
+
+  char digits[kMaxIntChars];
+  unsigned int count = 0;
+  do {
+    digits[count++] = static_cast<char>('0' + magnitude % 10);
+    magnitude /= 10;
+  } while (magnitude > 0);
+
+  while (count > 0) {
+    *out++ = digits[--count];
+  }
+  return out;
+}
+
+inline void AppendInt(std::string& output, long long value) {
+  char buffer[kMaxIntChars];
+  output.append(buffer, FormatInt(buffer, value));
+}
+
+inline bool IsSpace(char c) { return c == ' ' || c == '\n' || c == '\r' || c == '\t'; }
+
+/* Skips whitespace, then reads an optionally signed decimal integer and advances in past it, as
+ * operator>> does. Returns false, with value 0, if there is no integer. Out-of-range values
+ * saturate at the limits of int, as operator>> leaves them. */
+inline bool ParseInt(char const*& in, char const* end, int& value) {
+  while (in != end && IsSpace(*in)) {
+    ++in;
+  }
+
+  char const* cursor = in;
+  bool negative = false;
+  if (cursor != end && (*cursor == '-' || *cursor == '+')) {
+    negative = *cursor == '-';
+    ++cursor;
+  }
+  if (cursor == end || *cursor < '0' || *cursor > '9') {
+    value = 0;
+    return false;
+  }
+
+  /* Stops growing once past any int, so that long runs of digits cannot overflow it. */
+  long long constexpr kLimit = 1LL + std::numeric_limits<int>::max();
+  long long magnitude = 0;
+  while (cursor != end && *cursor >= '0' && *cursor <= '9') {
+    if (magnitude <= kLimit) {
+      magnitude = magnitude * 10 + (*cursor - '0');
+    }
+    ++cursor;
+  }
+  if (negative) {
+    value = magnitude >= kLimit ? std::numeric_limits<int>::min() : static_cast<int>(-magnitude);
+  } else {
+    value = magnitude >= kLimit ? std::numeric_limits<int>::max() : static_cast<int>(magnitude);
+  }
+  in = cursor;
+  return true;
+}
+
+/* Skips whitespace, then reads the next run of non-whitespace into word. */
+inline bool ParseWord(char const*& in, char const* end, std::string& word) {
+  while (in != end && IsSpace(*in)) {
+    ++in;
+  }
+  char const* begin = in;
+  while (in != end && !IsSpace(*in)) {
+    ++in;
+  }
+  word.assign(begin, in);
+  return in != begin;
+}
+
+/* One pod's command, "x y action", as a controller writes it. */
+inline bool ParseCommand(char const*& in, char const* end, int& x, int& y, std::string& action) {
+  bool x_ok = ParseInt(in, end, x);
+  bool y_ok = ParseInt(in, end, y);
+  return ParseWord(in, end, action) && x_ok && y_ok;
+}
+
+/* The next line of input, in a buffer reused by every call on the thread. The protocol sends
+ * one record per line, so a record is read with one getline instead of a formatted extraction
+ * per field. */
+inline std::string const& ReadLine(std::istream& input) {
+  thread_local std::string line;
+  if (!std::getline(input, line)) {
+    line.clear();
+  }
+  return line;
+}
+
+/* Reads the next line of input as integers into fields, in order; missing ones are 0. */
+inline void ReadInts(std::istream& input, std::initializer_list<int*> fields) {
+  std::string const& line = ReadLine(input);
+  char const* in = line.data();
+  char const* end = in + line.size();
+  for (int* field : fields) {
+    ParseInt(in, end, *field);
+  }
+}
+
+}  // namespace protocol
+
+#endif
@@ -0,0 +1,94 @@
+#include "Trace.hpp"
+#include <cstdio>
+#include <mutex>
+#include <vector>
+
+namespace trace {
+
+static std::mutex registry_mutex;
+static std::vector<Ring*> registry;
+static unsigned int next_tid = 1;
+static std::string output_path = "trace.json";
+static std::FILE* output = nullptr;
+static uint64_t dropped = 0;
+
+Ring* Register() {
+  Ring* ring = new Ring();
+  std::lock_guard<std::mutex> lock(registry_mutex);
+  ring->tid = next_tid++;
+  registry.push_back(ring);
+  return ring;
+}
+
+void SetOutput(std::string const& path) {
+  std::lock_guard<std::mutex> lock(registry_mutex);
+  output_path = path;
+}
+
+static void Write(Event const& event, unsigned int tid) {
+  if (event.phase == 'M') {
+    std::fprintf(output,
+                 "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,"
+                 "\"args\":{\"name\":\"%s\"}},\n",
+                 tid, event.name);
+    return;
+  }
+
+  std::fprintf(output,
+               "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f",
+               event.name, tid, event.start_ns / 1e3, event.duration_ns / 1e3);
+  if (event.arg >= 0) {
+    std::fprintf(output, ",\"args\":{\"index\":%lld}", static_cast<long long>(event.arg));
+  }
+  std::fprintf(output, "},\n");
+}
+
+void Flush() {
+  std::lock_guard<std::mutex> lock(registry_mutex);
+  if (!output) {
+    output = std::fopen(output_path.c_str(), "w");
+    if (!output) {
+      return;
+    }
+    /* The JSON array form of the format; a missing closing bracket is allowed. */
+    std::fprintf(output, "[\n");
+  }
+
+  std::vector<Ring*> live;
+  for (Ring* ring : registry) {
+    /* Read before draining: a retired ring gets no more events after this. */
+    bool retired = ring->retired.load(std::memory_order_acquire);
+    uint64_t t = ring->tail.load(std::memory_order_relaxed);
+    uint64_t h = ring->head.load(std::memory_order_acquire);
+    for (; t < h; ++t) {
+      Write(ring->events[t & (Ring::kCapacity - 1)], ring->tid);
+    }
+    ring->tail.store(h, std::memory_order_release);
+    dropped += ring->dropped.exchange(0, std::memory_order_relaxed);
+
+    if (retired) {
+      delete ring;
+    } else {
+      live.push_back(ring);
+    }
+  }
+  registry.swap(live);
+  std::fflush(output);
+}
+
+#ifdef PODRACING_TRACE
+/* Runs after thread_local destructors, so the main thread's ring is retired and drained too. */
+static struct FlushAtExit {
+  ~FlushAtExit() {
+    Flush();
+    if (output) {
+      std::fprintf(output, "{\"name\":\"dropped_events\",\"ph\":\"i\",\"s\":\"g\",\"pid\":1,"
+                           "\"tid\":0,\"ts\":0,\"args\":{\"count\":%llu}}\n]\n",
+                   static_cast<unsigned long long>(dropped));
+      std::fclose(output);
+    }
+  }
+} flush_at_exit;
+#endif
+
+}  // namespace trace
@@ -0,0 +1,107 @@
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+/* Timeline spans in Chrome trace event format (open the file in Perfetto or chrome://tracing),
+ * compiled in with -DPODRACING_TRACE (make TRACE=1). Each thread appends to its own lock-free
+ * ring; TRACE_FLUSH drains every ring into the output file, by default ./trace.json. Without the
+ * define the macros expand to nothing. Span names must be string literals. */
+namespace trace {
+
+struct Event {
+  char const* name;
+  uint64_t start_ns;
+  uint64_t duration_ns;
+  int64_t arg; /* -1 = none */
+  char phase;  /* 'X' span, 'M' thread name */
+};
+
+/* Single producer (the owning thread), single consumer (Flush). Full rings drop events. */
+struct Ring {
+  static unsigned int constexpr kCapacity = 1 << 12;
+
+  Event events[kCapacity];
+  std::atomic<uint64_t> head{0};
+  std::atomic<uint64_t> tail{0};
+  std::atomic<uint64_t> dropped{0};
+  std::atomic<bool> retired{false};
+  unsigned int tid;
+
+  void Push(Event const& event) {
+    uint64_t h = head.load(std::memory_order_relaxed);
+    if (h - tail.load(std::memory_order_acquire) >= kCapacity) {
+      dropped.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    events[h & (kCapacity - 1)] = event;
+    head.store(h + 1, std::memory_order_release);
+  }
+};
+
+Ring* Register();
+void SetOutput(std::string const& path);
+void Flush();
+
+/* Marks the ring for reclamation once the thread that owns it exits. */
+struct LocalRing {
+  Ring* ring = Register();
+  ~LocalRing() { ring->retired.store(true, std::memory_order_release); }
+};
+
+inline Ring& Local() {
+  thread_local LocalRing local;
+  return *local.ring;
+}
+
+inline uint64_t Now() {
+  static auto const epoch = std::chrono::steady_clock::now();
+  auto elapsed = std::chrono::steady_clock::now() - epoch;
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+}
+
+inline void SetThreadName(char const* name) { Local().Push({name, Now(), 0, -1, 'M'}); }
+
+class Span {
+ public:
+  Span(char const* name, int64_t arg = -1) : name_(name), arg_(arg), start_(Now()) {}
+  ~Span() { End(); }
+
+  /* Ends this span and starts the next one in the same scope. */
+  void Next(char const* name) {
+    End();
+    name_ = name;
+    arg_ = -1;
+    start_ = Now();
+  }
+
+ private:
+  void End() { Local().Push({name_, start_, Now() - start_, arg_, 'X'}); }
+
+  char const* name_;
+  int64_t arg_;
+  uint64_t start_;
+};
+
+}  // namespace trace
+
+#ifdef PODRACING_TRACE
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SPAN(...) trace::Span TRACE_CONCAT(trace_span_, __LINE__)(__VA_ARGS__)
+#define TRACE_PHASE(name) trace::Span trace_phase(name)
+#define TRACE_NEXT_PHASE(name) trace_phase.Next(name)
+#define TRACE_THREAD_NAME(name) trace::SetThreadName(name)
+#define TRACE_FLUSH() trace::Flush()
+#else
+#define TRACE_SPAN(...) ((void)0)
+#define TRACE_PHASE(name) ((void)0)
+#define TRACE_NEXT_PHASE(name) ((void)0)
+#define TRACE_THREAD_NAME(name) ((void)0)
+#define TRACE_FLUSH() ((void)0)
+#endif
+
+#endif
@@ -0,0 +1,171 @@
+#include "TranspositionTable.hpp"
+#include <cmath>
+#include <cstring>
+
+Zobrist::Zobrist() {
+  /* splitmix64 from a fixed seed: the same keys every run, and no draws from rand(). */
+  uint64_t seed = 0x9e3779b97f4a7c15ull;
+  auto next = [&seed]() {
+    uint64_t z = (seed += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+  };
+  for (auto& pod : pods_) {
+    for (auto& byte : pod) {
+      for (auto& key : byte) {
+        key = next();
+      }
+    }
+  }
+  for (auto& player : players_) {
+    for (auto& byte : player) {
+      for (auto& key : byte) {
+        key = next();
+      }
+    }
+  }
+}
+
+Zobrist const& Zobrist::Instance() {
+  static Zobrist const instance;
+  return instance;
+}
+
+uint64_t Zobrist::Hash(ForwardState const& state) {
+  Zobrist const& keys = Instance();
+  uint64_t hash = 0;
+  for (unsigned int i = 0; i < ForwardState::kPods; ++i) {
+    PodState pod = state.pods[i].GetState();
+    double degrees = std::atan2(pod.direction.y(), pod.direction.x()) * 180 / Vec2::pi();
+    uint16_t fields[] = {static_cast<uint16_t>(static_cast<int>(pod.position.x())),
+                         static_cast<uint16_t>(static_cast<int>(pod.position.y())),
+                         static_cast<uint16_t>(static_cast<int>(pod.velocity.x())),
+                         static_cast<uint16_t>(static_cast<int>(pod.velocity.y())),
+                         static_cast<uint16_t>(static_cast<int>(std::round(degrees + 360)) % 360),
+                         static_cast<uint16_t>(pod.lap << 8 | pod.next_checkpoint << 12 |
+                                               (pod.shield_cooldown & 0xff))};
+    for (unsigned int f = 0; f < kPodBytes / 2; ++f) {
+      hash ^= keys.pods_[i][f * 2][fields[f] & 0xff];
+      hash ^= keys.pods_[i][f * 2 + 1][fields[f] >> 8];
+    }
+  }
+  for (unsigned int p = 0; p < 2; ++p) {
+    hash ^= keys.players_[p][0][state.timeout[p] & 0xff];
+    hash ^= keys.players_[p][1][state.boosts_available[p] & 0xff];
+  }
+  return hash;
+}
+
+TranspositionTable::TranspositionTable(size_t megabytes, Replacement replacement)
+    : replacement_(replacement) {
+  size_t buckets = 1;
+  while (buckets * 2 * sizeof(Bucket) <= megabytes << 20) {
+    buckets *= 2;
+  }
+  buckets_.reset(new Bucket[buckets]);
+  mask_ = buckets - 1;
+  Clear();
+}
+
+bool TranspositionTable::Probe(uint64_t key, Entry& entry) {
+  probes_.fetch_add(1, std::memory_order_relaxed);
+  Bucket& bucket = buckets_[key & mask_];
+  for (Slot& slot : bucket.slots) {
+    uint64_t data = slot.data.load(std::memory_order_relaxed);
+    if ((slot.check.load(std::memory_order_relaxed) ^ data) == key) {
+      entry = Unpack(data);
+      hits_.fetch_add(1, std::memory_order_relaxed);
+      return true;
+    }
+  }
+  return false;
+}
+
+void TranspositionTable::Store(uint64_t key, Entry const& entry) {
+  stores_.fetch_add(1, std::memory_order_relaxed);
+  uint8_t generation = generation_.load(std::memory_order_relaxed);
+  Bucket& bucket = buckets_[key & mask_];
+
+  Slot* victim = nullptr;
+  bool evicts = true;
+  for (Slot& slot : bucket.slots) {
+    uint64_t data = slot.data.load(std::memory_order_relaxed);
+    uint64_t check = slot.check.load(std::memory_order_relaxed);
+    if ((check ^ data) == key || (check == 0 && data == 0)) {
+      victim = &slot;
+      evicts = false;
+      break;
+    }
+  }
+
+  if (victim == nullptr) {
+    switch (replacement_) {
+      case Replacement::kAlways:
+        victim = &bucket.slots[(key >> 62) & (kSlots - 1)];
+        break;
+      case Replacement::kDepth:
+      case Replacement::kAgeThenDepth: {
+        /* Lowest (stale, depth) wins; staleness only counts for kAgeThenDepth. */
+        int best = 0x7fffffff;
+        for (Slot& slot : bucket.slots) {
+          uint64_t data = slot.data.load(std::memory_order_relaxed);
+          bool current = replacement_ == Replacement::kDepth || Generation(data) == generation;
+          int rank = (current ? 256 : 0) + Depth(data);
+          if (rank < best) {
+            best = rank;
+            victim = &slot;
+          }
+        }
+        break;
+      }
+    }
+  }
+
+  if (evicts) {
+    replacements_.fetch_add(1, std::memory_order_relaxed);
+  }
+  uint64_t data = Pack(entry, generation);
+  victim->check.store(key ^ data, std::memory_order_relaxed);
+  victim->data.store(data, std::memory_order_relaxed);
+}
+
+void TranspositionTable::Clear() {
+  for (uint64_t b = 0; b <= mask_; ++b) {
+    for (Slot& slot : buckets_[b].slots) {
+      slot.check.store(0, std::memory_order_relaxed);
+      slot.data.store(0, std::memory_order_relaxed);
+    }
+  }
+  probes_ = 0;
+  hits_ = 0;
+  stores_ = 0;
+  replacements_ = 0;
+}
+
+TranspositionTable::Stats TranspositionTable::stats() const {
+  return {probes_.load(), hits_.load(), stores_.load(), replacements_.load()};
+}
+
+void TranspositionTable::Stats::Print(std::ostream& output) const {
+  output << "transpositions: " << probes << " probes, " << hits << " hits ("
+         << static_cast<int>(hit_rate() * 100) << "%), " << stores << " stores, " << replacements
+         << " replacements" << std::endl;
+}
+
+/* value:32 | generation:8 | depth:8 | move:16 */
+uint64_t TranspositionTable::Pack(Entry const& entry, uint8_t generation) {
+  uint32_t value;
+  std::memcpy(&value, &entry.value, sizeof(value));
+  return static_cast<uint64_t>(value) << 32 | static_cast<uint64_t>(generation) << 24 |
+         static_cast<uint64_t>(entry.depth) << 16 | entry.move;
+}
+
+TranspositionTable::Entry TranspositionTable::Unpack(uint64_t data) {
+  Entry entry;
+  uint32_t value = data >> 32;
+  std::memcpy(&entry.value, &value, sizeof(value));
+  entry.depth = Depth(data);
+  entry.move = data & 0xffff;
+  return entry;
+}
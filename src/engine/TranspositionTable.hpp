@@ -0,0 +1,97 @@
+#ifndef TRANSPOSITIONTABLE_HPP
+#define TRANSPOSITIONTABLE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include "ForwardModel.hpp"
+
+/* Zobrist hash of a ForwardState. EndTurn leaves positions rounded and velocities truncated, so
+ * those hash exactly; the heading is hashed in whole degrees, as the game reports it, so states
+ * that differ by less than a degree of heading share a key. */
+class Zobrist {
+ public:
+  static uint64_t Hash(ForwardState const& state);
+
+ private:
+  /* Each field is hashed a byte at a time, so the key tables stay small. */
+  static unsigned int constexpr kPodBytes = 12;
+  static unsigned int constexpr kPlayerBytes = 2;
+
+  Zobrist();
+  static Zobrist const& Instance();
+
+  uint64_t pods_[ForwardState::kPods][kPodBytes][256];
+  uint64_t players_[2][kPlayerBytes][256];
+};
+
+/* A fixed-size hash table of search results that any number of threads can probe and store
+ * without locks. Each slot keeps its key XORed with its data, so a slot torn by two racing
+ * stores fails the key check on the next probe instead of returning the wrong data. */
+class TranspositionTable {
+ public:
+  enum class Replacement {
+    kAlways,       /* A new key overwrites one fixed slot of its bucket. */
+    kDepth,        /* A new key overwrites the shallowest slot of its bucket. */
+    kAgeThenDepth, /* Slots from older searches go first, then the shallowest. */
+  };
+
+  struct Entry {
+    float value;
+    uint16_t move;
+    uint8_t depth;
+  };
+
+  struct Stats {
+    uint64_t probes;
+    uint64_t hits;
+    uint64_t stores;
+    uint64_t replacements; /* Stores that evicted another key. */
+
+    double hit_rate() const { return probes > 0 ? static_cast<double>(hits) / probes : 0.0; }
+    void Print(std::ostream& output) const;
+  };
+
+  /* Rounds the table down to a power-of-two number of buckets fitting in `megabytes`. */
+  TranspositionTable(size_t megabytes, Replacement replacement = Replacement::kAgeThenDepth);
+
+  bool Probe(uint64_t key, Entry& entry);
+  void Store(uint64_t key, Entry const& entry);
+
+  /* Marks everything stored so far as old, for kAgeThenDepth. */
+  void NewSearch() { generation_.fetch_add(1, std::memory_order_relaxed); }
+  void Clear();
+
+  Stats stats() const;
+  size_t size() const { return (mask_ + 1) * kSlots; }
+
+ private:
+  static unsigned int constexpr kSlots = 4;
+
+  struct Slot {
+    std::atomic<uint64_t> check; /* key ^ data */
+    std::atomic<uint64_t> data;
+  };
+  struct alignas(64) Bucket {
+    Slot slots[kSlots];
+  };
+
+  static uint64_t Pack(Entry const& entry, uint8_t generation);
+  static Entry Unpack(uint64_t data);
+  static uint8_t Depth(uint64_t data) { return data >> 16; }
+  static uint8_t Generation(uint64_t data) { return data >> 24; }
+
+  std::unique_ptr<Bucket[]> buckets_;
+  uint64_t mask_;
+  Replacement replacement_;
+  std::atomic<uint8_t> generation_{1};
+
+  alignas(64) std::atomic<uint64_t> probes_{0};
+  std::atomic<uint64_t> hits_{0};
+  std::atomic<uint64_t> stores_{0};
+  std::atomic<uint64_t> replacements_{0};
+};
+
+#endif
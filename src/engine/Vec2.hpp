@@ -2,40 +2,51 @@
 #define VECTOR_H
 
 #include <math.h>
+#include <cmath>
+#include "FastMath.hpp"
 
-class Vec2 {
+/* A 2D vector over a floating point Scalar. The referee and everything that talks the protocol
+ * use Vec2 (double); Vec2T<float> is for simulations that trade precision for width. */
+template <typename T>
+class Vec2T {
  public:
+  typedef T Scalar;
+
   /* Constructors */
-  Vec2(double x = 0.0, double y = 0.0) : x_(x), y_(y) {}
-  Vec2(Vec2 const& p) : Vec2(p.x_, p.y_) {}
+  Vec2T(T x = 0.0, T y = 0.0) : x_(x), y_(y) {}
+  Vec2T(Vec2T const& p) : Vec2T(p.x_, p.y_) {}
+  template <typename U>
+  explicit Vec2T(Vec2T<U> const& p) : Vec2T(p.x(), p.y()) {}
+  Vec2T& operator=(Vec2T const& p) = default;
 
   /* Accessors */
-  double x() const { return x_; }
-  double y() const { return y_; }
-  double Length() const { return sqrt(*this * *this); }
+  T x() const { return x_; }
+  T y() const { return y_; }
+  T Length() const { return std::sqrt(*this * *this); }
   inline int Degrees() const;
 
   /* Modifiers */
-  inline void Normalize() { *this *= (1.0 / Length()); }
+  inline void Normalize() { *this *= (T(1.0) / Length()); }
   inline void Truncate();
   inline void Round();
   inline void Rotate(double angle);
+  inline void Rotate(T cos_angle, T sin_angle);
 
   /* Operators */
-  inline Vec2 operator*(double scalar) const;
-  inline Vec2& operator*=(double scalar);
-  inline double operator*(Vec2 const& other) const;
-  inline Vec2 operator+(Vec2 const& other) const;
-  inline Vec2& operator+=(Vec2 const& other);
-  inline Vec2 operator-(Vec2 const& other) const;
-  inline Vec2& operator-=(Vec2 const& other);
+  inline Vec2T operator*(T scalar) const;
+  inline Vec2T& operator*=(T scalar);
+  inline T operator*(Vec2T const& other) const;
+  inline Vec2T operator+(Vec2T const& other) const;
+  inline Vec2T& operator+=(Vec2T const& other);
+  inline Vec2T operator-(Vec2T const& other) const;
+  inline Vec2T& operator-=(Vec2T const& other);
 
   /* Utilities */
-  static inline double Dot(Vec2 const& left, Vec2 const& right);
-  static inline double Cross(Vec2 const& left, Vec2 const& right);
-  static inline Vec2 Perpendicular(Vec2 const& to);
-  static constexpr double pi() { return std::atan(1) * 4; }
-  static double Cap(double a, double limit) {
+  static inline T Dot(Vec2T const& left, Vec2T const& right);
+  static inline T Cross(Vec2T const& left, Vec2T const& right);
+  static inline Vec2T Perpendicular(Vec2T const& to);
+  static constexpr double pi() { return fastmath::kPi; }
+  static T Cap(T a, T limit) {
     if (a > limit) {
       return limit;
     } else if (a < -limit) {
@@ -46,80 +57,97 @@ class Vec2 {
   }
 
  private:
-  double x_;
-  double y_;
+  T x_;
+  T y_;
 };
 
-int Vec2::Degrees() const {
-  int angle = static_cast<int>(std::atan(y_ / x_) * 180 / pi());
+typedef Vec2T<double> Vec2;
 
-  if (x_ < 0) {
-    angle += 180;
-  } else if (x_ == 0) {
-    if (y_ > 0) {
-      angle = 90;
-    } else {
-      angle = 270;
-    }
-  }
-  if (angle < 0) {
-    angle += 360;
-  }
-
-  return angle;
+template <typename T>
+int Vec2T<T>::Degrees() const {
+  return fastmath::Degrees(x_, y_);
 }
 
-void Vec2::Truncate() {
+template <typename T>
+void Vec2T<T>::Truncate() {
   x_ = x_ > 0 ? std::floor(x_) : std::ceil(x_);
   y_ = y_ > 0 ? std::floor(y_) : std::ceil(y_);
 }
 
-void Vec2::Round() {
+template <typename T>
+void Vec2T<T>::Round() {
   x_ = std::round(x_);
   y_ = std::round(y_);
 }
 
-void Vec2::Rotate(double angle) {
-  double x, y;
-  x = std::cos(angle) * x_ - std::sin(angle) * y_;
-  y = std::sin(angle) * x_ + std::cos(angle) * y_;
+template <typename T>
+void Vec2T<T>::Rotate(double angle) {
+  Rotate(fastmath::Cos(angle), fastmath::Sin(angle));
+}
+
+/* By an angle given as its cosine and sine, for angles that are known ahead of time. */
+template <typename T>
+void Vec2T<T>::Rotate(T cos_angle, T sin_angle) {
+  T x, y;
+  x = cos_angle * x_ - sin_angle * y_;
+  y = sin_angle * x_ + cos_angle * y_;
   x_ = x;
   y_ = y;
 }
 
-Vec2 Vec2::operator*(double scalar) const { return Vec2(x_ * scalar, y_ * scalar); }
+template <typename T>
+Vec2T<T> Vec2T<T>::operator*(T scalar) const {
+  return Vec2T(x_ * scalar, y_ * scalar);
+}
 
-Vec2& Vec2::operator*=(double scalar) {
+template <typename T>
+Vec2T<T>& Vec2T<T>::operator*=(T scalar) {
   *this = *this * scalar;
   return *this;
 }
 
-double Vec2::operator*(Vec2 const& other) const { return x_ * other.x_ + y_ * other.y_; }
+template <typename T>
+T Vec2T<T>::operator*(Vec2T const& other) const {
+  return x_ * other.x_ + y_ * other.y_;
+}
 
-Vec2 Vec2::operator+(Vec2 const& other) const { return Vec2(x_ + other.x_, y_ + other.y_); }
+template <typename T>
+Vec2T<T> Vec2T<T>::operator+(Vec2T const& other) const {
+  return Vec2T(x_ + other.x_, y_ + other.y_);
+}
 
-Vec2& Vec2::operator+=(Vec2 const& other) {
+template <typename T>
+Vec2T<T>& Vec2T<T>::operator+=(Vec2T const& other) {
   *this = *this + other;
   return *this;
 }
 
-Vec2 Vec2::operator-(Vec2 const& other) const { return Vec2(x_ - other.x_, y_ - other.y_); }
+template <typename T>
+Vec2T<T> Vec2T<T>::operator-(Vec2T const& other) const {
+  return Vec2T(x_ - other.x_, y_ - other.y_);
+}
 
-Vec2& Vec2::operator-=(Vec2 const& other) {
+template <typename T>
+Vec2T<T>& Vec2T<T>::operator-=(Vec2T const& other) {
   *this = *this - other;
   return *this;
 }
 
-double Vec2::Dot(Vec2 const& left, Vec2 const& right) { return left * right; }
+template <typename T>
+T Vec2T<T>::Dot(Vec2T const& left, Vec2T const& right) {
+  return left * right;
+}
 
-double Vec2::Cross(Vec2 const& left, Vec2 const& right) {
+template <typename T>
+T Vec2T<T>::Cross(Vec2T const& left, Vec2T const& right) {
   return (left.x_ * right.y_ - left.y_ * right.x_);
 }
 
-Vec2 Vec2::Perpendicular(Vec2 const& to) {
-  Vec2 p(to);
+template <typename T>
+Vec2T<T> Vec2T<T>::Perpendicular(Vec2T const& to) {
+  Vec2T p(to);
   p.Rotate(-pi() / 2);
   return p;
 }
 
-#endif
\ No newline at end of file
+#endif
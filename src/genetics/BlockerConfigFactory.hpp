@@ -1,16 +1,31 @@
 #ifndef BLOCKERFACTORY_HPP
 #define BLOCKERFACTORY_HPP
 
+#include <algorithm>
+#include <cstring>
+#include <string>
 #include "DualAdvancedRunner.hpp"
 #include "GameServer.hpp"
 #include "GeneticAlgorithm.hpp"
+#include "League.hpp"
 #include "NeuralNetwork.hpp"
 #include "RunnerBlocker.hpp"
+#include "Scenario.hpp"
+#include "StaticGameController.hpp"
 
-class BlockerFactory : public ISpeciesFactory<RunnerBlocker::Config> {
+class BlockerFactory : public ISpeciesFactory<RunnerBlocker::Config>,
+                       public IMatchFactory<RunnerBlocker::Config> {
  public:
   static unsigned int constexpr kConfigCount = sizeof(RunnerBlocker::Config) / sizeof(double);
 
+  /* Search box for optimisers that need explicit parameter bounds. */
+  static RunnerBlocker::Config LowerBound() {
+    return RunnerBlocker::Config{0.5, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+  }
+  static RunnerBlocker::Config UpperBound() {
+    return RunnerBlocker::Config{3.0, 4000.0, 4000.0, 6000.0, 6000.0, 1500.0, 8000.0, 10.0};
+  }
+
   RunnerBlocker::Config GenerateRandomSpecies() const override { return RunnerBlocker::Config(); }
   RunnerBlocker::Config SparseMutate(RunnerBlocker::Config const& t1) override {
     RunnerBlocker::Config config = t1;
@@ -40,33 +55,135 @@ class BlockerFactory : public ISpeciesFactory<RunnerBlocker::Config> {
     return SparseMutate(config);
   }
   double Evaluate(RunnerBlocker::Config& t1) override {
-    NeuralNetwork runner(advanced_runner);
+    if (scenarios_) {
+      return PlayScenarios(t1);
+    }
+    return Play(t1, 50, Fidelity::Full);
+  }
+  double Screen(RunnerBlocker::Config& t1) override { return Play(t1, 20, Fidelity::Screen); }
+  /* Evaluate on short mid-race scenarios instead of full games (nullptr for full games). */
+  void SetScenarios(ScenarioLibrary const* scenarios, unsigned int horizon) {
+    scenarios_ = scenarios;
+    scenario_horizon_ = horizon;
+  }
+
+  double Match(RunnerBlocker::Config& t1, RunnerBlocker::Config& t2) override {
+    static unsigned int constexpr kIterations = 10;
+    RunnerBlocker controller1(t2);
+    RunnerBlocker controller2(t1);
+    GameController server;
+    server.AddPlayer(controller1);
+    server.AddPlayer(controller2);
 
-    static unsigned int constexpr kIterations = 50;
     double f = 0.0;
     for (unsigned int j = 0; j < kIterations; ++j) {
-      DualAdvancedRunner controller1(runner);
-      RunnerBlocker controller2(t1);
+      server.Reset();
+      f += Score(server);
+    }
+    ReportLatency(server, "blocker", "blocker");
+
+    f /= kIterations;
+    return f;
+  }
+  std::string Serialize(RunnerBlocker::Config const& t1) const override {
+    return std::string(reinterpret_cast<char const*>(&t1), sizeof(t1));
+  }
+  bool Deserialize(std::string const& data, RunnerBlocker::Config& t1) const override {
+    if (data.size() != sizeof(t1)) {
+      return false;
+    }
+    std::memcpy(&t1, data.data(), sizeof(t1));
+    return true;
+  }
 
-      GameController server;
-      server.AddPlayer(controller1);
-      server.AddPlayer(controller2);
-      int winner = server.RunGame();
+ private:
+  /* One set of controllers and one game controller per evaluation, reset between games. */
+  double Play(RunnerBlocker::Config& t1, unsigned int iterations, Fidelity fidelity) {
+    NeuralNetwork runner(advanced_runner);
+    DualAdvancedRunner controller1(runner);
+    RunnerBlocker controller2(t1);
+
+    if (fidelity == Fidelity::Full) {
+      /* Same game, without virtual calls or per-turn allocation. */
+      StaticGameController<2, DualAdvancedRunner, RunnerBlocker> server(controller1, controller2);
+      double f = PlayGames(server, iterations);
+      ReportLatency(server, "advanced_runner", "blocker");
+      return f;
+    }
+
+    GameController server;
+    server.SetFidelity(fidelity);
+    server.AddPlayer(controller1);
+    server.AddPlayer(controller2);
+    double f = PlayGames(server, iterations);
+    ReportLatency(server, "advanced_runner", "blocker");
+    return f;
+  }
+
+  /* Adds the evaluation's controller latencies to GameController::latency_report(). */
+  static void ReportLatency(GameController const& server, char const* name0, char const* name1) {
+    GameController::latency_report().Merge(name0, server.player(0).setup_latency(),
+                                           server.player(0).turn_latency());
+    GameController::latency_report().Merge(name1, server.player(1).setup_latency(),
+                                           server.player(1).turn_latency());
+  }
+  template <typename... Controllers>
+  static void ReportLatency(StaticGameController<2, Controllers...> const& server,
+                            char const* name0, char const* name1) {
+    GameController::latency_report().Merge(name0, server.setup_latency(0),
+                                           server.turn_latency(0));
+    GameController::latency_report().Merge(name1, server.setup_latency(1),
+                                           server.turn_latency(1));
+  }
+
+  template <typename Server>
+  static double PlayGames(Server& server, unsigned int iterations) {
+    double f = 0.0;
+    for (unsigned int j = 0; j < iterations; ++j) {
+      server.Reset();
+      f += Score(server);
+    }
+    return f / iterations;
+  }
+
+  template <typename Server>
+  static double Score(Server& server) {
+    int winner = server.RunGame();
+    double p0_fitness = (winner == 0) ? 0.0 : server.GetFitness(0);
+    double p1_fitness = (winner == 1) ? 0.0 : server.GetFitness(1);
+    return (1.0 + p1_fitness - p0_fitness) / 2;
+  }
+
+  double PlayScenarios(RunnerBlocker::Config& t1) {
+    NeuralNetwork runner(advanced_runner);
+    DualAdvancedRunner controller1(runner);
+    RunnerBlocker controller2(t1);
+    GameController server;
+    server.AddPlayer(controller1);
+    server.AddPlayer(controller2);
+
+    double f = 0.0;
+    for (unsigned int j = 0; j < scenarios_->size(); ++j) {
+      server.Reset();
+      int winner = server.RunScenario((*scenarios_)[j], scenario_horizon_);
       double p0_fitness = (winner == 0) ? 0.0 : server.GetFitness(0);
       double p1_fitness = (winner == 1) ? 0.0 : server.GetFitness(1);
 
       f += ((1.0 + p1_fitness - p0_fitness) / 2);
     }
+    ReportLatency(server, "advanced_runner", "blocker");
 
-    f /= kIterations;
+    f /= std::max(scenarios_->size(), 1u);
     return f;
   }
 
- private:
   static double r(double min = -1.0, double max = 1.0) {
     double f = (double)rand() / RAND_MAX;
     return min + f * (max - min);
   }
+
+  ScenarioLibrary const* scenarios_ = nullptr;
+  unsigned int scenario_horizon_ = 0;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,316 @@
+#ifndef CMAES_HPP
+#define CMAES_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "GeneticAlgorithm.hpp"
+#include "ParallelEvaluate.hpp"
+
+/* Covariance matrix adaptation evolution strategy for species that are plain structs of doubles,
+ * such as RunnerBlocker::Config. Sampling happens in a unit cube mapped onto [lower, upper], so
+ * parameters with very different scales share one step size. Samples that leave the cube are
+ * scored at the nearest in-bounds point plus a quadratic penalty. Lower fitness is better, as in
+ * GeneticAlgorithm. */
+template <class T>
+class CmaEs {
+ public:
+  static unsigned int constexpr kDimension = sizeof(T) / sizeof(double);
+  static_assert(sizeof(T) % sizeof(double) == 0, "CmaEs species must be a struct of doubles");
+
+  CmaEs(ISpeciesFactory<T>& factory, T const& initial, T const& lower, T const& upper,
+        unsigned int lambda = 0, double sigma = 0.3);
+
+  /* Sample, evaluate and update once. Returns the current mean, the best estimate so far. */
+  T Generation(unsigned int generation_index);
+
+  double sigma() const { return sigma_; }
+
+ private:
+  typedef std::vector<double> Vector;
+  typedef std::vector<double> Matrix; /* row major, kDimension x kDimension */
+
+  T ToSpecies(Vector const& y) const;
+  Vector FromSpecies(T const& t) const;
+  void UpdateEigensystem();
+  static void Jacobi(Matrix& a, Matrix& vectors, Vector& values);
+  static double Norm(Vector const& v);
+
+  ISpeciesFactory<T>& factory_;
+  double lower_[kDimension];
+  double upper_[kDimension];
+  std::mt19937 rng_;
+
+  /* Strategy parameters */
+  unsigned int lambda_;
+  unsigned int mu_;
+  Vector weights_;
+  double mueff_;
+  double cc_, cs_, c1_, cmu_, damps_, chi_n_;
+
+  /* State */
+  Vector mean_;
+  double sigma_;
+  Matrix c_;
+  Matrix b_;
+  Vector d_;
+  Vector pc_;
+  Vector ps_;
+  unsigned int updates_ = 0;
+};
+
+template <class T>
+CmaEs<T>::CmaEs(ISpeciesFactory<T>& factory, T const& initial, T const& lower, T const& upper,
+                unsigned int lambda, double sigma)
+    : factory_(factory), rng_(std::rand()), sigma_(sigma) {
+  double const n = kDimension;
+  double const* lo = reinterpret_cast<double const*>(&lower);
+  double const* hi = reinterpret_cast<double const*>(&upper);
+  std::copy(lo, lo + kDimension, lower_);
+  std::copy(hi, hi + kDimension, upper_);
+
+  lambda_ = lambda > 0 ? lambda : 4 + static_cast<unsigned int>(3 * std::log(n));
+  mu_ = lambda_ / 2;
+  for (unsigned int i = 0; i < mu_; ++i) {
+    weights_.push_back(std::log(mu_ + 0.5) - std::log(i + 1.0));
+  }
+  double sum = 0.0;
+  double sum_sq = 0.0;
+  for (double w : weights_) {
+    sum += w;
+  }
+  for (double& w : weights_) {
+    w /= sum;
+    sum_sq += w * w;
+  }
+  mueff_ = 1.0 / sum_sq;
+
+  cc_ = (4 + mueff_ / n) / (n + 4 + 2 * mueff_ / n);
+  cs_ = (mueff_ + 2) / (n + mueff_ + 5);
+  c1_ = 2 / ((n + 1.3) * (n + 1.3) + mueff_);
+  cmu_ = std::min(1 - c1_, 2 * (mueff_ - 2 + 1 / mueff_) / ((n + 2) * (n + 2) + mueff_));
+  damps_ = 1 + 2 * std::max(0.0, std::sqrt((mueff_ - 1) / (n + 1)) - 1) + cs_;
+  chi_n_ = std::sqrt(n) * (1 - 1 / (4 * n) + 1 / (21 * n * n));
+
+  mean_ = FromSpecies(initial);
+  c_ = Matrix(kDimension * kDimension, 0.0);
+  b_ = Matrix(kDimension * kDimension, 0.0);
+  for (unsigned int i = 0; i < kDimension; ++i) {
+    c_[i * kDimension + i] = 1.0;
+    b_[i * kDimension + i] = 1.0;
+  }
+  d_ = Vector(kDimension, 1.0);
+  pc_ = Vector(kDimension, 0.0);
+  ps_ = Vector(kDimension, 0.0);
+}
+
+template <class T>
+T CmaEs<T>::Generation(unsigned int generation_index) {
+  std::normal_distribution<double> normal;
+
+  /* y_k = B * D * z_k, x_k = m + sigma * y_k */
+  std::vector<Vector> steps(lambda_, Vector(kDimension));
+  std::vector<Vector> samples(lambda_, Vector(kDimension));
+  for (unsigned int k = 0; k < lambda_; ++k) {
+    Vector z(kDimension);
+    for (auto& zi : z) {
+      zi = normal(rng_);
+    }
+    for (unsigned int i = 0; i < kDimension; ++i) {
+      double y = 0.0;
+      for (unsigned int j = 0; j < kDimension; ++j) {
+        y += b_[i * kDimension + j] * d_[j] * z[j];
+      }
+      steps[k][i] = y;
+      samples[k][i] = mean_[i] + sigma_ * y;
+    }
+  }
+
+  std::vector<Evaluation> evals;
+  ParallelEvaluate(
+      lambda_,
+      [this, &samples](unsigned int k) {
+        Vector clamped = samples[k];
+        double penalty = 0.0;
+        for (auto& y : clamped) {
+          double c = std::min(1.0, std::max(0.0, y));
+          penalty += (y - c) * (y - c);
+          y = c;
+        }
+        T species = ToSpecies(clamped);
+        return factory_.Evaluate(species) + penalty;
+      },
+      evals, std::time(0));
+
+  std::sort(evals.begin(), evals.end(), [](Evaluation const& left, Evaluation const& right) {
+    return left.second < right.second;
+  });
+
+  /* Recombine the best mu steps into the new mean. */
+  Vector step(kDimension, 0.0);
+  for (unsigned int r = 0; r < mu_; ++r) {
+    Vector const& y = steps[evals[r].first];
+    for (unsigned int i = 0; i < kDimension; ++i) {
+      step[i] += weights_[r] * y[i];
+    }
+  }
+  for (unsigned int i = 0; i < kDimension; ++i) {
+    mean_[i] += sigma_ * step[i];
+  }
+
+  /* Step size path uses C^-1/2 * step = B * D^-1 * B^T * step */
+  Vector bt_step(kDimension, 0.0);
+  for (unsigned int j = 0; j < kDimension; ++j) {
+    for (unsigned int i = 0; i < kDimension; ++i) {
+      bt_step[j] += b_[i * kDimension + j] * step[i];
+    }
+    bt_step[j] /= d_[j];
+  }
+  double const cs_norm = std::sqrt(cs_ * (2 - cs_) * mueff_);
+  for (unsigned int i = 0; i < kDimension; ++i) {
+    double c_inv_sqrt_step = 0.0;
+    for (unsigned int j = 0; j < kDimension; ++j) {
+      c_inv_sqrt_step += b_[i * kDimension + j] * bt_step[j];
+    }
+    ps_[i] = (1 - cs_) * ps_[i] + cs_norm * c_inv_sqrt_step;
+  }
+
+  updates_++;
+  double ps_norm = Norm(ps_);
+  bool hsig = ps_norm / std::sqrt(1 - std::pow(1 - cs_, 2.0 * updates_)) / chi_n_ <
+              1.4 + 2.0 / (kDimension + 1);
+
+  double const cc_norm = std::sqrt(cc_ * (2 - cc_) * mueff_);
+  for (unsigned int i = 0; i < kDimension; ++i) {
+    pc_[i] = (1 - cc_) * pc_[i] + (hsig ? cc_norm * step[i] : 0.0);
+  }
+
+  /* Rank-one and rank-mu covariance update. */
+  double const decay = 1 - c1_ - cmu_ + (hsig ? 0.0 : c1_ * cc_ * (2 - cc_));
+  for (unsigned int i = 0; i < kDimension; ++i) {
+    for (unsigned int j = 0; j <= i; ++j) {
+      double rank_mu = 0.0;
+      for (unsigned int r = 0; r < mu_; ++r) {
+        Vector const& y = steps[evals[r].first];
+        rank_mu += weights_[r] * y[i] * y[j];
+      }
+      double c = decay * c_[i * kDimension + j] + c1_ * pc_[i] * pc_[j] + cmu_ * rank_mu;
+      c_[i * kDimension + j] = c;
+      c_[j * kDimension + i] = c;
+    }
+  }
+
+  sigma_ *= std::exp((cs_ / damps_) * (ps_norm / chi_n_ - 1));
+  UpdateEigensystem();
+
+  std::cout << "cmaes" << generation_index << " sigma: " << sigma_ << " best: ";
+  for (unsigned int i = 0; i < std::min(lambda_, 10u); ++i) {
+    std::cout << evals[i].second << " ";
+  }
+  std::cout << std::endl;
+
+  return ToSpecies(mean_);
+}
+
+template <class T>
+T CmaEs<T>::ToSpecies(Vector const& y) const {
+  T species;
+  double* p = reinterpret_cast<double*>(&species);
+  for (unsigned int i = 0; i < kDimension; ++i) {
+    p[i] = lower_[i] + y[i] * (upper_[i] - lower_[i]);
+  }
+  return species;
+}
+
+template <class T>
+typename CmaEs<T>::Vector CmaEs<T>::FromSpecies(T const& t) const {
+  double const* p = reinterpret_cast<double const*>(&t);
+  Vector y(kDimension);
+  for (unsigned int i = 0; i < kDimension; ++i) {
+    y[i] = (p[i] - lower_[i]) / (upper_[i] - lower_[i]);
+  }
+  return y;
+}
+
+template <class T>
+void CmaEs<T>::UpdateEigensystem() {
+  Matrix a = c_;
+  Vector values;
+  Jacobi(a, b_, values);
+  for (unsigned int i = 0; i < kDimension; ++i) {
+    d_[i] = std::sqrt(std::max(values[i], 1e-20));
+  }
+}
+
+/* Cyclic Jacobi rotations; plenty for the handful of dimensions this is used with. */
+template <class T>
+void CmaEs<T>::Jacobi(Matrix& a, Matrix& vectors, Vector& values) {
+  unsigned int const n = kDimension;
+  vectors.assign(n * n, 0.0);
+  for (unsigned int i = 0; i < n; ++i) {
+    vectors[i * n + i] = 1.0;
+  }
+
+  for (unsigned int sweep = 0; sweep < 50; ++sweep) {
+    double off = 0.0;
+    for (unsigned int i = 0; i < n; ++i) {
+      for (unsigned int j = i + 1; j < n; ++j) {
+        off += a[i * n + j] * a[i * n + j];
+      }
+    }
+    if (off < 1e-30) {
+      break;
+    }
+
+    for (unsigned int p = 0; p < n; ++p) {
+      for (unsigned int q = p + 1; q < n; ++q) {
+        double apq = a[p * n + q];
+        if (std::abs(apq) < 1e-300) {
+          continue;
+        }
+        double theta = (a[q * n + q] - a[p * n + p]) / (2 * apq);
+        double t = (theta >= 0 ? 1.0 : -1.0) / (std::abs(theta) + std::sqrt(theta * theta + 1));
+        double c = 1 / std::sqrt(t * t + 1);
+        double s = t * c;
+
+        for (unsigned int k = 0; k < n; ++k) {
+          double akp = a[k * n + p];
+          double akq = a[k * n + q];
+          a[k * n + p] = c * akp - s * akq;
+          a[k * n + q] = s * akp + c * akq;
+        }
+        for (unsigned int k = 0; k < n; ++k) {
+          double apk = a[p * n + k];
+          double aqk = a[q * n + k];
+          a[p * n + k] = c * apk - s * aqk;
+          a[q * n + k] = s * apk + c * aqk;
+        }
+        for (unsigned int k = 0; k < n; ++k) {
+          double vkp = vectors[k * n + p];
+          double vkq = vectors[k * n + q];
+          vectors[k * n + p] = c * vkp - s * vkq;
+          vectors[k * n + q] = s * vkp + c * vkq;
+        }
+      }
+    }
+  }
+
+  values.resize(n);
+  for (unsigned int i = 0; i < n; ++i) {
+    values[i] = a[i * n + i];
+  }
+}
+
+template <class T>
+double CmaEs<T>::Norm(Vector const& v) {
+  double sum = 0.0;
+  for (double x : v) {
+    sum += x * x;
+  }
+  return std::sqrt(sum);
+}
+
+#endif
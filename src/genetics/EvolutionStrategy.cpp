@@ -0,0 +1,113 @@
+#include "EvolutionStrategy.hpp"
+#include <algorithm>
+#include <ctime>
+#include <iostream>
+#include "ParallelEvaluate.hpp"
+
+NoiseTable::NoiseTable(unsigned int size, unsigned int seed) : noise_(size) {
+  std::mt19937 rng(seed);
+  std::normal_distribution<float> normal;
+  for (auto& n : noise_) {
+    n = normal(rng);
+  }
+}
+
+unsigned int NoiseTable::SampleIndex(std::mt19937& rng, unsigned int dimension) const {
+  std::uniform_int_distribution<unsigned int> index(0, noise_.size() - dimension);
+  return index(rng);
+}
+
+EvolutionStrategy::EvolutionStrategy(NeuralNetworkFactory& factory, NeuralNetwork const& initial,
+                                     Config const& config)
+    : factory_(factory),
+      config_(config),
+      noise_(config.noise_size, config.noise_seed),
+      rng_(std::rand()),
+      network_(initial),
+      theta_(NeuralNetworkFactory::Flatten(initial)) {}
+
+NeuralNetwork EvolutionStrategy::Generation(unsigned int generation_index) {
+  std::vector<unsigned int> indices(config_.pairs);
+  for (auto& index : indices) {
+    index = noise_.SampleIndex(rng_, theta_.size());
+  }
+
+  /* Even slots are theta + sigma * eps, odd slots theta - sigma * eps. */
+  std::vector<Evaluation> evals;
+  ParallelEvaluate(
+      2 * config_.pairs,
+      [this, &indices](unsigned int i) {
+        NeuralNetwork candidate = Perturbed(indices[i / 2], (i % 2 == 0) ? 1.0 : -1.0);
+        return factory_.Evaluate(candidate);
+      },
+      evals, std::time(0));
+
+  std::vector<PairResult> results(config_.pairs);
+  for (unsigned int p = 0; p < config_.pairs; ++p) {
+    results[p].noise_index = indices[p];
+    results[p].fitness_positive = evals[2 * p].second;
+    results[p].fitness_negative = evals[2 * p + 1].second;
+  }
+  Update(results);
+
+  std::sort(evals.begin(), evals.end(), [](Evaluation const& left, Evaluation const& right) {
+    return left.second < right.second;
+  });
+  std::cout << "es" << generation_index << " best: ";
+  for (unsigned int i = 0; i < std::min<unsigned int>(10, evals.size()); ++i) {
+    std::cout << evals[i].second << " ";
+  }
+  std::cout << std::endl;
+
+  return network_;
+}
+
+void EvolutionStrategy::Update(std::vector<PairResult> const& results) {
+  unsigned int const n = results.size();
+  if (n == 0) {
+    return;
+  }
+
+  /* Centred ranks in [-0.5, 0.5] over all 2n scores make the step invariant to fitness scale. */
+  std::vector<std::pair<double, unsigned int>> order;
+  for (unsigned int p = 0; p < n; ++p) {
+    order.push_back({results[p].fitness_positive, 2 * p});
+    order.push_back({results[p].fitness_negative, 2 * p + 1});
+  }
+  std::sort(order.begin(), order.end());
+  std::vector<double> rank(2 * n);
+  for (unsigned int r = 0; r < order.size(); ++r) {
+    rank[order[r].second] = (2 * n > 1) ? static_cast<double>(r) / (2 * n - 1) - 0.5 : 0.0;
+  }
+
+  unsigned int const dimension = theta_.size();
+  std::vector<double> gradient(dimension, 0.0);
+  double* g = gradient.data();
+  for (unsigned int p = 0; p < n; ++p) {
+    double weight = rank[2 * p] - rank[2 * p + 1];
+    float const* eps = noise_.At(results[p].noise_index);
+    for (unsigned int j = 0; j < dimension; ++j) {
+      g[j] += weight * eps[j];
+    }
+  }
+
+  /* Descend: a higher rank is a worse (larger) fitness. */
+  double const step = config_.learning_rate / (n * config_.sigma);
+  for (unsigned int j = 0; j < dimension; ++j) {
+    theta_[j] -= step * g[j] + config_.learning_rate * config_.weight_decay * theta_[j];
+  }
+  NeuralNetworkFactory::Unflatten(network_, theta_);
+}
+
+NeuralNetwork EvolutionStrategy::Perturbed(unsigned int noise_index, double sign) const {
+  std::vector<double> theta = theta_;
+  float const* eps = noise_.At(noise_index);
+  double const scale = sign * config_.sigma;
+  for (unsigned int j = 0; j < theta.size(); ++j) {
+    theta[j] += scale * eps[j];
+  }
+
+  NeuralNetwork candidate = network_;
+  NeuralNetworkFactory::Unflatten(candidate, theta);
+  return candidate;
+}
@@ -0,0 +1,71 @@
+#ifndef EVOLUTIONSTRATEGY_HPP
+#define EVOLUTIONSTRATEGY_HPP
+
+#include <random>
+#include <vector>
+#include "NeuralNetwork.hpp"
+#include "NeuralNetworkFactory.hpp"
+
+/* Large block of N(0, 1) samples generated from a fixed seed. Any process that builds a table with
+ * the same seed and size holds identical noise, so a perturbation is fully described by its offset
+ * into the table. */
+class NoiseTable {
+ public:
+  NoiseTable(unsigned int size, unsigned int seed);
+
+  float const* At(unsigned int index) const { return noise_.data() + index; }
+  unsigned int SampleIndex(std::mt19937& rng, unsigned int dimension) const;
+
+ private:
+  std::vector<float> noise_;
+};
+
+/* OpenAI-style evolution strategy over the flattened weights of a NeuralNetwork. Each generation
+ * scores antithetic pairs theta +/- sigma * eps, where eps is a slice of the shared noise table.
+ * Workers report only (noise index, fitness) pairs. The update is a centred-rank weighted sum of
+ * noise slices. Lower fitness is better, as in GeneticAlgorithm. */
+class EvolutionStrategy {
+ public:
+  struct Config {
+    unsigned int pairs = 256;
+    double sigma = 0.02;
+    double learning_rate = 0.01;
+    double weight_decay = 0.005;
+    unsigned int noise_size = 1 << 24;
+    unsigned int noise_seed = 0x5eed;
+  };
+
+  /* Fitness of one antithetic pair; all a remote worker needs to send back. */
+  struct PairResult {
+    unsigned int noise_index;
+    double fitness_positive;
+    double fitness_negative;
+  };
+
+  /* The noise table must hold at least one slice as long as the genome: check with NoiseFits. */
+  EvolutionStrategy(NeuralNetworkFactory& factory, NeuralNetwork const& initial,
+                    Config const& config);
+
+  static bool NoiseFits(Config const& config, NeuralNetwork const& initial) {
+    return NeuralNetworkFactory::Flatten(initial).size() <= config.noise_size;
+  }
+
+  NeuralNetwork Generation(unsigned int generation_index);
+
+  /* Apply one update from results gathered anywhere. */
+  void Update(std::vector<PairResult> const& results);
+
+  NeuralNetwork const& network() const { return network_; }
+
+ private:
+  NeuralNetwork Perturbed(unsigned int noise_index, double sign) const;
+
+  NeuralNetworkFactory& factory_;
+  Config config_;
+  NoiseTable noise_;
+  std::mt19937 rng_;
+  NeuralNetwork network_;
+  std::vector<double> theta_;
+};
+
+#endif
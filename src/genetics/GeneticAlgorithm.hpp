@@ -1,11 +1,16 @@
 #ifndef GENETICALGORITHM_HPP
 #define GENETICALGORITHM_HPP
 
-#include <windows.h>
 #include <algorithm>
 #include <ctime>
+#include <cmath>
 #include <iostream>
+#include <limits>
+#include <string>
 #include <vector>
+#include "ParallelEvaluate.hpp"
+#include "PerfCounters.hpp"
+#include "Trace.hpp"
 
 template <class T>
 class ISpeciesFactory {
@@ -14,8 +19,16 @@ class ISpeciesFactory {
   virtual T SparseMutate(T const& t1) = 0;
   virtual T CrossMutate(T const& t1, T const& t2) = 0;
   virtual double Evaluate(T& t1) = 0;
+  /* Cheap, approximate Evaluate for a first screening round. */
+  virtual double Screen(T& t1) { return Evaluate(t1); }
+  virtual std::string Serialize(T const& t1) const = 0;
+  /* False if data is not something Serialize produced. */
+  virtual bool Deserialize(std::string const& data, T& t1) const = 0;
 };
 
+template <class T>
+class League;
+
 template <class T>
 class GeneticAlgorithm {
  public:
@@ -23,29 +36,35 @@ class GeneticAlgorithm {
 
   T Generation(unsigned int generation_index);
 
- private:
-  struct EvaluateParams {
-    std::pair<unsigned int, double>* evals;
-    T* candidates;
-    unsigned int index;
-    unsigned int size;
-    ISpeciesFactory<T>* factory;
-    unsigned int seed;
-  };
-
-  static DWORD WINAPI Evaluate(LPVOID lpParameter) {
-    EvaluateParams* params = static_cast<EvaluateParams*>(lpParameter);
-    for (unsigned int i = 0; i < params->size; ++i) {
-      std::srand(params->seed);
-      params->evals[i] = std::pair<unsigned int, double>(
-          params->index + i, params->factory->Evaluate(params->candidates[i]));
-    }
-    return 0;
+  /* Survivors of the last generation, best first. */
+  std::vector<T> const& elites() const { return survivors_; }
+
+  /* Replace the tail of the next generation with genomes bred elsewhere. */
+  void Immigrate(std::vector<T> const& migrants);
+
+  /* Score candidates against a hall-of-fame archive instead of the factory's fixed opponent. */
+  void SetLeague(League<T>* league) { league_ = league; }
+
+  /* Screen every candidate cheaply and only fully evaluate the best fraction. Every
+   * report_interval generations all candidates are scored both ways and the rank correlation
+   * between the two is printed, so the screen can be checked against the real thing. */
+  void SetScreening(double fraction, unsigned int report_interval = 10) {
+    screen_fraction_ = fraction;
+    screen_report_interval_ = report_interval;
   }
 
+ private:
+  void ScreenedEvaluate(unsigned int generation_index, std::vector<Evaluation>& evals);
+  static double RankCorrelation(std::vector<double> const& a, std::vector<double> const& b);
+  static std::vector<double> Ranks(std::vector<double> const& values);
+
   ISpeciesFactory<T>& factory_;
   std::vector<T> population_;
+  std::vector<T> survivors_;
   unsigned int pop_;
+  League<T>* league_ = nullptr;
+  double screen_fraction_ = 1.0;
+  unsigned int screen_report_interval_ = 0;
 };
 
 template <class T>
@@ -59,47 +78,36 @@ GeneticAlgorithm<T>::GeneticAlgorithm(ISpeciesFactory<T>& factory, unsigned int
 static unsigned int constexpr kSavedPeaks = 1;
 template <class T>
 T GeneticAlgorithm<T>::Generation(unsigned int generation_index) {
-  std::vector<std::pair<unsigned int, double>> evals(pop_);
-  std::vector<HANDLE> threads;
-
-  unsigned int pop = pop_;
-  unsigned int batches = 16;
-  std::vector<EvaluateParams> params(batches);
-
-  for (unsigned int i = 0; i < batches; ++i) {
-    unsigned int division = batches - 1;
-    unsigned int index = i * (pop_ / division);
-    unsigned int batch_size = std::min(pop, pop_ / division);
-    pop -= std::min(pop_ / division, pop);
-
-    EvaluateParams p;
-    p.evals = &evals[index];
-    p.candidates = &population_[index];
-    p.size = batch_size;
-    p.factory = &factory_;
-    p.index = index;
-    p.seed = std::time(0);
-    params[i] = p;
-
-    HANDLE h =
-        CreateThread(0, 0, (LPTHREAD_START_ROUTINE)Evaluate, (PVOID)(params.data() + i), 0, 0);
-    threads.push_back(h);
-  }
-
-  for (auto& thread : threads) {
-    WaitForSingleObject(thread, INFINITE);
+  TRACE_SPAN("generation", generation_index);
+  TRACE_PHASE("evaluate");
+  std::vector<Evaluation> evals;
+  if (league_) {
+    league_->Evaluate(population_, evals);
+  } else if (screen_fraction_ < 1.0) {
+    ScreenedEvaluate(generation_index, evals);
+  } else {
+    ParallelEvaluate(
+        pop_, [this](unsigned int i) { return factory_.Evaluate(population_[i]); }, evals,
+        std::time(0));
   }
 
+  TRACE_NEXT_PHASE("sort");
   std::sort(
       evals.begin(), evals.end(),
       [](std::pair<unsigned int, double> const& left,
          std::pair<unsigned int, double> const& right) { return left.second < right.second; });
 
-  std::vector<T> survivors;
+  TRACE_NEXT_PHASE("breed");
+  PERF_REGION(kRegionBreed);
+  std::vector<T>& survivors = survivors_;
+  survivors.clear();
   for (unsigned int i = 0; i < pop_ / 5; ++i) {
     unsigned int survivor_index = evals[i].first;
     survivors.push_back(population_[survivor_index]);
   }
+  if (league_) {
+    league_->Admit(survivors[0], generation_index);
+  }
 
   population_.clear();
   for (unsigned int i = 0; i < pop_; ++i) {
@@ -111,14 +119,123 @@ T GeneticAlgorithm<T>::Generation(unsigned int generation_index) {
       population_.push_back(factory_.CrossMutate(survivors[rand1], survivors[rand2]));
     }
   }
+  if (league_) {
+    league_->Prune(population_);
+  }
 
+  TRACE_NEXT_PHASE("log");
   std::cout << "gen" << generation_index << " best: ";
   for (unsigned int i = 0; i < 10; ++i) {
     std::cout << evals[i].second << " ";
   }
   std::cout << std::endl;
 
+  TRACE_NEXT_PHASE("flush");
+  TRACE_FLUSH();
   return population_[0];
 }
 
+template <class T>
+void GeneticAlgorithm<T>::ScreenedEvaluate(unsigned int generation_index,
+                                           std::vector<Evaluation>& evals) {
+  unsigned int seed = std::time(0);
+  std::vector<Evaluation> screened;
+  ParallelEvaluate(
+      pop_, [this](unsigned int i) { return factory_.Screen(population_[i]); }, screened, seed);
+
+  bool report = screen_report_interval_ > 0 && generation_index % screen_report_interval_ == 0;
+  std::vector<Evaluation> order = screened;
+  std::sort(order.begin(), order.end(), [](Evaluation const& left, Evaluation const& right) {
+    return left.second < right.second;
+  });
+
+  /* Always promote at least as many as survive, so survivors are picked on full fitness. */
+  unsigned int promoted = std::max<unsigned int>(std::ceil(screen_fraction_ * pop_), pop_ / 5);
+  promoted = std::min(report ? pop_ : promoted, pop_);
+  std::vector<unsigned int> indices(promoted);
+  for (unsigned int i = 0; i < promoted; ++i) {
+    indices[i] = order[i].first;
+  }
+
+  std::vector<Evaluation> full;
+  ParallelEvaluate(
+      promoted,
+      [this, &indices](unsigned int i) { return factory_.Evaluate(population_[indices[i]]); },
+      full, seed);
+
+  /* Candidates the screen rejected sort after every fully evaluated one. */
+  evals.assign(pop_, Evaluation(0, std::numeric_limits<double>::max()));
+  for (unsigned int i = 0; i < pop_; ++i) {
+    evals[i].first = i;
+  }
+  for (unsigned int i = 0; i < promoted; ++i) {
+    evals[indices[i]].second = full[i].second;
+  }
+
+  if (report) {
+    std::vector<double> cheap(pop_);
+    std::vector<double> exact(pop_);
+    for (unsigned int i = 0; i < pop_; ++i) {
+      cheap[i] = screened[i].second;
+      exact[i] = evals[i].second;
+    }
+    std::cout << "gen" << generation_index
+              << " screen rank correlation: " << RankCorrelation(cheap, exact) << std::endl;
+  }
+}
+
+/* Spearman's rho. */
+template <class T>
+double GeneticAlgorithm<T>::RankCorrelation(std::vector<double> const& a,
+                                            std::vector<double> const& b) {
+  std::vector<double> ra = Ranks(a);
+  std::vector<double> rb = Ranks(b);
+  double n = ra.size();
+  double mean = (n - 1) / 2;
+  double cov = 0.0, va = 0.0, vb = 0.0;
+  for (unsigned int i = 0; i < ra.size(); ++i) {
+    cov += (ra[i] - mean) * (rb[i] - mean);
+    va += (ra[i] - mean) * (ra[i] - mean);
+    vb += (rb[i] - mean) * (rb[i] - mean);
+  }
+  if (va == 0.0 || vb == 0.0) {
+    return 0.0;
+  }
+  return cov / std::sqrt(va * vb);
+}
+
+/* Zero-based ranks, ties share their average rank. */
+template <class T>
+std::vector<double> GeneticAlgorithm<T>::Ranks(std::vector<double> const& values) {
+  std::vector<unsigned int> order(values.size());
+  for (unsigned int i = 0; i < order.size(); ++i) {
+    order[i] = i;
+  }
+  std::sort(order.begin(), order.end(), [&values](unsigned int left, unsigned int right) {
+    return values[left] < values[right];
+  });
+
+  std::vector<double> ranks(values.size());
+  for (unsigned int i = 0; i < order.size();) {
+    unsigned int j = i;
+    while (j + 1 < order.size() && values[order[j + 1]] == values[order[i]]) {
+      j++;
+    }
+    for (unsigned int k = i; k <= j; ++k) {
+      ranks[order[k]] = (i + j) / 2.0;
+    }
+    i = j + 1;
+  }
+  return ranks;
+}
+
+template <class T>
+void GeneticAlgorithm<T>::Immigrate(std::vector<T> const& migrants) {
+  /* Never overwrite the preserved elite in slot 0. */
+  unsigned int count = std::min<unsigned int>(migrants.size(), pop_ - 1);
+  for (unsigned int i = 0; i < count; ++i) {
+    population_[pop_ - 1 - i] = migrants[i];
+  }
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,185 @@
+#ifndef ISLAND_HPP
+#define ISLAND_HPP
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "GeneticAlgorithm.hpp"
+
+/* Decides which islands talk to each other and how often. Every island process builds the same
+ * coordinator from the same settings, so no central server is needed; the shared directory is the
+ * only thing the processes have in common. */
+class MigrationCoordinator {
+ public:
+  enum class Topology { Ring, Broadcast };
+
+  struct Config {
+    std::string directory = "./islands";
+    unsigned int island_count = 1;
+    unsigned int interval = 10; /* generations between migrations; 0 never migrates */
+    unsigned int migrants = 4;
+    Topology topology = Topology::Ring;
+  };
+
+  MigrationCoordinator(Config const& config) : config_(config) {}
+
+  bool ShouldMigrate(unsigned int generation_index) const {
+    return config_.island_count > 1 && config_.interval > 0 &&
+           generation_index % config_.interval == 0;
+  }
+
+  std::vector<unsigned int> Destinations(unsigned int island) const {
+    std::vector<unsigned int> destinations;
+    if (config_.topology == Topology::Ring) {
+      destinations.push_back((island + 1) % config_.island_count);
+    } else {
+      for (unsigned int i = 0; i < config_.island_count; ++i) {
+        if (i != island) {
+          destinations.push_back(i);
+        }
+      }
+    }
+    return destinations;
+  }
+
+  Config const& config() const { return config_; }
+
+ private:
+  Config config_;
+};
+
+/* One GA process in an island model. Elites are exchanged as binary genome files in a shared
+ * directory: each file is written under a temporary name and renamed into place, so a reader never
+ * sees a partial file. */
+template <class T>
+class Island {
+ public:
+  Island(GeneticAlgorithm<T>& ga, ISpeciesFactory<T>& factory,
+         MigrationCoordinator const& coordinator, unsigned int id);
+
+  /* Call after each generation: sends elites when due, and always takes in any arrivals. */
+  void Migrate(unsigned int generation_index);
+
+ private:
+  static uint32_t constexpr kMagic = 0x49534c44;  // "ISLD"
+
+  void Send(unsigned int generation_index);
+  void Receive();
+  std::string InboxPrefix(unsigned int island) const {
+    return "to" + std::to_string(island) + "_";
+  }
+  static bool ReadGenomes(std::filesystem::path const& path, std::vector<std::string>& genomes);
+
+  GeneticAlgorithm<T>& ga_;
+  ISpeciesFactory<T>& factory_;
+  MigrationCoordinator const& coordinator_;
+  unsigned int id_;
+};
+
+template <class T>
+Island<T>::Island(GeneticAlgorithm<T>& ga, ISpeciesFactory<T>& factory,
+                  MigrationCoordinator const& coordinator, unsigned int id)
+    : ga_(ga), factory_(factory), coordinator_(coordinator), id_(id) {
+  std::filesystem::create_directories(coordinator_.config().directory);
+}
+
+template <class T>
+void Island<T>::Migrate(unsigned int generation_index) {
+  if (coordinator_.ShouldMigrate(generation_index)) {
+    Send(generation_index);
+  }
+  Receive();
+}
+
+template <class T>
+void Island<T>::Send(unsigned int generation_index) {
+  std::vector<T> const& elites = ga_.elites();
+  uint32_t count = std::min<uint32_t>(elites.size(), coordinator_.config().migrants);
+  std::filesystem::path directory(coordinator_.config().directory);
+
+  for (unsigned int to : coordinator_.Destinations(id_)) {
+    std::string name = InboxPrefix(to) + "from" + std::to_string(id_) + "_gen" +
+                       std::to_string(generation_index) + ".genomes";
+    std::filesystem::path temp = directory / ("." + name + ".tmp");
+
+    std::ofstream file(temp, std::ios::binary);
+    file.write(reinterpret_cast<char const*>(&kMagic), sizeof(kMagic));
+    file.write(reinterpret_cast<char const*>(&count), sizeof(count));
+    for (uint32_t i = 0; i < count; ++i) {
+      std::string genome = factory_.Serialize(elites[i]);
+      uint32_t size = genome.size();
+      file.write(reinterpret_cast<char const*>(&size), sizeof(size));
+      file.write(genome.data(), size);
+    }
+    file.close();
+
+    std::error_code error;
+    std::filesystem::rename(temp, directory / name, error);
+    if (error) {
+      std::cerr << "island" << id_ << " failed to publish " << name << ": " << error.message()
+                << std::endl;
+    }
+  }
+}
+
+template <class T>
+void Island<T>::Receive() {
+  std::string prefix = InboxPrefix(id_);
+  std::vector<T> migrants;
+
+  std::error_code error;
+  for (auto const& entry :
+       std::filesystem::directory_iterator(coordinator_.config().directory, error)) {
+    std::string name = entry.path().filename().string();
+    if (name.compare(0, prefix.size(), prefix) != 0) {
+      continue;
+    }
+
+    std::vector<std::string> genomes;
+    if (ReadGenomes(entry.path(), genomes)) {
+      for (auto const& genome : genomes) {
+        T migrant;
+        if (factory_.Deserialize(genome, migrant)) {
+          migrants.push_back(migrant);
+        } else {
+          std::cerr << "island" << id_ << " skipped a bad genome in " << name << std::endl;
+        }
+      }
+    }
+    std::filesystem::remove(entry.path(), error);
+  }
+
+  if (!migrants.empty()) {
+    ga_.Immigrate(migrants);
+    std::cout << "island" << id_ << " received " << migrants.size() << " migrants" << std::endl;
+  }
+}
+
+template <class T>
+bool Island<T>::ReadGenomes(std::filesystem::path const& path, std::vector<std::string>& genomes) {
+  std::ifstream file(path, std::ios::binary);
+  uint32_t magic = 0;
+  uint32_t count = 0;
+  file.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+  file.read(reinterpret_cast<char*>(&count), sizeof(count));
+  if (!file || magic != kMagic) {
+    return false;
+  }
+
+  for (uint32_t i = 0; i < count; ++i) {
+    uint32_t size = 0;
+    file.read(reinterpret_cast<char*>(&size), sizeof(size));
+    std::string genome(size, '\0');
+    file.read(&genome[0], size);
+    if (!file) {
+      return false;
+    }
+    genomes.push_back(genome);
+  }
+  return true;
+}
+
+#endif
@@ -0,0 +1,276 @@
+#ifndef LEAGUE_HPP
+#define LEAGUE_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include "GeneticAlgorithm.hpp"
+#include "ParallelEvaluate.hpp"
+
+template <class T>
+class IMatchFactory {
+ public:
+  /* Score of t1 playing against t2, in [0, 1]; lower is better for t1. */
+  virtual double Match(T& t1, T& t2) = 0;
+};
+
+/* Hall-of-fame archive of past elites. Candidates are scored by playing a few archive members
+ * instead of one fixed opponent. Pairings that were already played are cached, keyed by a hash of
+ * the serialized genomes; the preserved elite and migrants reappear unchanged every generation,
+ * so they cost nothing the second time. Each member carries an Elo rating from its results. */
+template <class T>
+class League {
+ public:
+  struct Config {
+    unsigned int capacity = 16;
+    unsigned int opponents = 4;
+    unsigned int admit_interval = 10;
+  };
+
+  struct Member {
+    T genome;
+    size_t key;
+    double rating;
+    unsigned int matches;
+  };
+
+  League(ISpeciesFactory<T>& species, IMatchFactory<T>& matches, Config const& config);
+
+  /* Fills evals[i] with (i, fitness of candidates[i]). */
+  void Evaluate(std::vector<T>& candidates, std::vector<Evaluation>& evals);
+
+  /* Offer the current best; it joins the archive every admit_interval generations. */
+  void Admit(T const& elite, unsigned int generation_index);
+
+  /* Call once the next generation is bred: forgets every pairing whose first genome is neither
+   * an archive member nor one of candidates, since it can never be looked up again. */
+  void Prune(std::vector<T> const& candidates);
+
+  std::vector<Member> const& members() const { return members_; }
+  unsigned int cache_hits() const { return cache_hits_; }
+  unsigned int matches_played() const { return matches_played_; }
+
+ private:
+  typedef std::pair<size_t, size_t> Pairing;
+
+  static double constexpr kInitialRating = 1500.0;
+  static double constexpr kEloK = 16.0;
+
+  size_t Key(T const& t) const { return std::hash<std::string>()(species_.Serialize(t)); }
+  std::vector<unsigned int> Opponents() const;
+  void PlayPairings(std::vector<T>& firsts, std::vector<unsigned int> const& seconds,
+                    std::vector<Pairing> const& pairings);
+  void Rate(Member& member, double member_score, double opponent_rating);
+
+  ISpeciesFactory<T>& species_;
+  IMatchFactory<T>& matches_;
+  Config config_;
+  std::vector<Member> members_;
+  std::map<Pairing, double> cache_;
+  unsigned int cache_hits_ = 0;
+  unsigned int matches_played_ = 0;
+};
+
+template <class T>
+League<T>::League(ISpeciesFactory<T>& species, IMatchFactory<T>& matches, Config const& config)
+    : species_(species), matches_(matches), config_(config) {}
+
+template <class T>
+std::vector<unsigned int> League<T>::Opponents() const {
+  /* Always include the newest member, fill the rest from the highest rated. */
+  std::vector<unsigned int> order(members_.size());
+  for (unsigned int i = 0; i < order.size(); ++i) {
+    order[i] = i;
+  }
+  std::sort(order.begin(), order.end(), [this](unsigned int left, unsigned int right) {
+    return members_[left].rating > members_[right].rating;
+  });
+
+  std::vector<unsigned int> opponents;
+  if (!members_.empty()) {
+    opponents.push_back(members_.size() - 1);
+  }
+  for (unsigned int i : order) {
+    if (opponents.size() >= config_.opponents) {
+      break;
+    }
+    if (i != members_.size() - 1) {
+      opponents.push_back(i);
+    }
+  }
+  return opponents;
+}
+
+template <class T>
+void League<T>::Evaluate(std::vector<T>& candidates, std::vector<Evaluation>& evals) {
+  if (members_.empty()) {
+    ParallelEvaluate(
+        candidates.size(), [&](unsigned int i) { return species_.Evaluate(candidates[i]); },
+        evals, std::time(0));
+    return;
+  }
+
+  std::vector<unsigned int> opponents = Opponents();
+  std::vector<size_t> keys(candidates.size());
+  std::vector<Pairing> pairings;
+  for (unsigned int i = 0; i < candidates.size(); ++i) {
+    keys[i] = Key(candidates[i]);
+    for (unsigned int m : opponents) {
+      pairings.push_back(Pairing(keys[i], members_[m].key));
+    }
+  }
+
+  /* Schedule only the pairings we have never seen, once each. */
+  std::vector<Pairing> todo;
+  std::vector<unsigned int> todo_candidate;
+  std::vector<unsigned int> todo_member;
+  for (unsigned int p = 0; p < pairings.size(); ++p) {
+    if (cache_.count(pairings[p])) {
+      cache_hits_++;
+      continue;
+    }
+    if (std::find(todo.begin(), todo.end(), pairings[p]) != todo.end()) {
+      continue;
+    }
+    todo.push_back(pairings[p]);
+    todo_candidate.push_back(p / opponents.size());
+    todo_member.push_back(opponents[p % opponents.size()]);
+  }
+
+  std::vector<Evaluation> results;
+  ParallelEvaluate(
+      todo.size(),
+      [&](unsigned int t) {
+        T opponent = members_[todo_member[t]].genome;
+        return matches_.Match(candidates[todo_candidate[t]], opponent);
+      },
+      results, std::time(0));
+  matches_played_ += todo.size();
+
+  double mean_rating = 0.0;
+  for (auto const& member : members_) {
+    mean_rating += member.rating / members_.size();
+  }
+  for (unsigned int t = 0; t < todo.size(); ++t) {
+    cache_[todo[t]] = results[t].second;
+    /* Candidates are unrated, treat them as league average. */
+    Rate(members_[todo_member[t]], results[t].second, mean_rating);
+  }
+
+  evals.resize(candidates.size());
+  for (unsigned int i = 0; i < candidates.size(); ++i) {
+    double f = 0.0;
+    for (unsigned int m : opponents) {
+      f += cache_[Pairing(keys[i], members_[m].key)];
+    }
+    evals[i] = Evaluation(i, f / opponents.size());
+  }
+}
+
+template <class T>
+void League<T>::Admit(T const& elite, unsigned int generation_index) {
+  if (generation_index % config_.admit_interval != 0) {
+    return;
+  }
+  size_t key = Key(elite);
+  for (auto const& member : members_) {
+    if (member.key == key) {
+      return;
+    }
+  }
+
+  /* Seed the newcomer's rating by playing it against the whole archive. */
+  Member newcomer = {elite, key, kInitialRating, 0};
+  if (!members_.empty()) {
+    std::vector<T> firsts(1, elite);
+    std::vector<unsigned int> seconds(members_.size());
+    std::vector<Pairing> pairings;
+    for (unsigned int m = 0; m < members_.size(); ++m) {
+      seconds[m] = m;
+      pairings.push_back(Pairing(key, members_[m].key));
+    }
+    PlayPairings(firsts, seconds, pairings);
+
+    for (unsigned int m = 0; m < members_.size(); ++m) {
+      double score = cache_[pairings[m]];
+      double member_rating = members_[m].rating;
+      Rate(members_[m], score, newcomer.rating);
+      Rate(newcomer, 1.0 - score, member_rating);
+    }
+  }
+
+  if (members_.size() >= config_.capacity) {
+    /* Evict the weakest member and forget every pairing it took part in. */
+    auto weakest = std::min_element(
+        members_.begin(), members_.end(),
+        [](Member const& left, Member const& right) { return left.rating < right.rating; });
+    size_t evicted = weakest->key;
+    members_.erase(weakest);
+    for (auto it = cache_.begin(); it != cache_.end();) {
+      if (it->first.second == evicted || it->first.first == evicted) {
+        it = cache_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+  members_.push_back(newcomer);
+
+  std::cout << "league" << generation_index << " members: " << members_.size()
+            << " matches: " << matches_played_ << " cache hits: " << cache_hits_
+            << " cached: " << cache_.size() << std::endl;
+}
+
+template <class T>
+void League<T>::Prune(std::vector<T> const& candidates) {
+  std::vector<size_t> keep;
+  for (auto const& member : members_) {
+    keep.push_back(member.key);
+  }
+  for (auto const& candidate : candidates) {
+    keep.push_back(Key(candidate));
+  }
+  std::sort(keep.begin(), keep.end());
+
+  for (auto it = cache_.begin(); it != cache_.end();) {
+    if (!std::binary_search(keep.begin(), keep.end(), it->first.first)) {
+      it = cache_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+template <class T>
+void League<T>::PlayPairings(std::vector<T>& firsts, std::vector<unsigned int> const& seconds,
+                             std::vector<Pairing> const& pairings) {
+  std::vector<Evaluation> results;
+  ParallelEvaluate(
+      pairings.size(),
+      [&](unsigned int p) {
+        T opponent = members_[seconds[p]].genome;
+        return matches_.Match(firsts[p % firsts.size()], opponent);
+      },
+      results, std::time(0));
+  matches_played_ += pairings.size();
+
+  for (unsigned int p = 0; p < pairings.size(); ++p) {
+    cache_[pairings[p]] = results[p].second;
+  }
+}
+
+template <class T>
+void League<T>::Rate(Member& member, double member_score, double opponent_rating) {
+  /* member_score is the opponent's fitness, so a high value is a good result for the member. */
+  double expected = 1.0 / (1.0 + std::pow(10.0, (opponent_rating - member.rating) / 400.0));
+  member.rating += kEloK * (member_score - expected);
+  member.matches++;
+}
+
+#endif
@@ -85,15 +85,40 @@ NeuralNetwork NeuralNetworkFactory::CrossMutate(NeuralNetwork const& t1, NeuralN
   return SparseMutate(new_nn);
 };
 
-double NeuralNetworkFactory::Evaluate(NeuralNetwork& t1) {
+double NeuralNetworkFactory::Evaluate(NeuralNetwork& t1) { return Play(t1, 50, Fidelity::Full); }
+
+double NeuralNetworkFactory::Screen(NeuralNetwork& t1) { return Play(t1, 20, Fidelity::Screen); }
+
+double NeuralNetworkFactory::Play(NeuralNetwork& t1, unsigned int iterations, Fidelity fidelity) {
   NeuralNetwork simple(simple_runner);
 
-  static unsigned int constexpr kIterations = 50;
   double f = 0.0;
-  for (unsigned int j = 0; j < kIterations; ++j) {
+  for (unsigned int j = 0; j < iterations; ++j) {
     DualSimpleRunner controller1(simple);
     DualRunnerFinal controller2(t1);
 
+    GameController server;
+    server.SetFidelity(fidelity);
+    server.AddPlayer(controller1);
+    server.AddPlayer(controller2);
+    int winner = server.RunGame();
+    double p0_fitness = (winner == 0) ? 0.0 : server.GetFitness(0);
+    double p1_fitness = (winner == 1) ? 0.0 : server.GetFitness(1);
+
+    f += ((1.0 + p1_fitness - p0_fitness) / 2);
+  }
+
+  f /= iterations;
+  return f;
+};
+
+double NeuralNetworkFactory::Match(NeuralNetwork& t1, NeuralNetwork& t2) {
+  static unsigned int constexpr kIterations = 10;
+  double f = 0.0;
+  for (unsigned int j = 0; j < kIterations; ++j) {
+    DualRunnerFinal controller1(t2);
+    DualRunnerFinal controller2(t1);
+
     GameController server;
     server.AddPlayer(controller1);
     server.AddPlayer(controller2);
@@ -1,19 +1,30 @@
 #ifndef NNFACTORY_HPP
 #define NNFACTORY_HPP
 
+#include "GameServer.hpp"
 #include "GeneticAlgorithm.hpp"
+#include "League.hpp"
 #include "NeuralNetwork.hpp"
 
-class NeuralNetworkFactory : public ISpeciesFactory<NeuralNetwork> {
+class NeuralNetworkFactory : public ISpeciesFactory<NeuralNetwork>,
+                             public IMatchFactory<NeuralNetwork> {
  public:
   NeuralNetwork GenerateRandomSpecies() const override;
   NeuralNetwork SparseMutate(NeuralNetwork const& t1) override;
   NeuralNetwork CrossMutate(NeuralNetwork const& t1, NeuralNetwork const& t2) override;
   double Evaluate(NeuralNetwork& t1) override;
+  double Screen(NeuralNetwork& t1) override;
+  double Match(NeuralNetwork& t1, NeuralNetwork& t2) override;
+  std::string Serialize(NeuralNetwork const& t1) const override { return t1.Save(); }
+  bool Deserialize(std::string const& data, NeuralNetwork& t1) const override {
+    return t1.Load(data);
+  }
 
- private:
   static std::vector<double> Flatten(NeuralNetwork const& network);
   static void Unflatten(NeuralNetwork& network, std::vector<double> const& flat);
+
+ private:
+  double Play(NeuralNetwork& t1, unsigned int iterations, Fidelity fidelity);
   NeuralNetwork GenerateRandomNetwork() const;
 
   static double r(double min = -1.0, double max = 1.0) {
@@ -0,0 +1,77 @@
+#ifndef PARALLELEVALUATE_HPP
+#define PARALLELEVALUATE_HPP
+
+#include <windows.h>
+#include <algorithm>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+#include "Trace.hpp"
+
+typedef std::pair<unsigned int, double> Evaluation;
+
+/* Fan evaluate(i) for i in [0, count) out over worker threads. Every evaluation reseeds the
+ * worker's rand() with the same seed, so all candidates are scored on the same set of maps. */
+template <class F>
+class ParallelEvaluator {
+ public:
+  static unsigned int constexpr kThreads = 16;
+
+  static void Run(unsigned int count, F const& evaluate, std::vector<Evaluation>& evals,
+                  unsigned int seed) {
+    evals.resize(count);
+    unsigned int threads = std::min(kThreads, count);
+    if (threads == 0) {
+      return;
+    }
+    unsigned int batch = (count + threads - 1) / threads;
+
+    std::vector<Params> params(threads);
+    std::vector<HANDLE> handles;
+    for (unsigned int i = 0; i < threads; ++i) {
+      Params& p = params[i];
+      p.evals = evals.data();
+      p.evaluate = &evaluate;
+      p.begin = std::min(count, i * batch);
+      p.end = std::min(count, p.begin + batch);
+      p.seed = seed;
+
+      handles.push_back(
+          CreateThread(0, 0, (LPTHREAD_START_ROUTINE)Worker, (PVOID)(params.data() + i), 0, 0));
+    }
+
+    for (auto& handle : handles) {
+      WaitForSingleObject(handle, INFINITE);
+      CloseHandle(handle);
+    }
+  }
+
+ private:
+  struct Params {
+    Evaluation* evals;
+    F const* evaluate;
+    unsigned int begin;
+    unsigned int end;
+    unsigned int seed;
+  };
+
+  static DWORD WINAPI Worker(LPVOID lpParameter) {
+    Params* params = static_cast<Params*>(lpParameter);
+    TRACE_THREAD_NAME("worker");
+    TRACE_SPAN("worker");
+    for (unsigned int i = params->begin; i < params->end; ++i) {
+      TRACE_SPAN("evaluate", i);
+      std::srand(params->seed);
+      params->evals[i] = Evaluation(i, (*params->evaluate)(i));
+    }
+    return 0;
+  }
+};
+
+template <class F>
+void ParallelEvaluate(unsigned int count, F const& evaluate, std::vector<Evaluation>& evals,
+                      unsigned int seed) {
+  ParallelEvaluator<F>::Run(count, evaluate, evals, seed);
+}
+
+#endif
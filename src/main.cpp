@@ -1,24 +1,187 @@
 #include <ctime>
 #include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
 #include "BlockerConfigFactory.hpp"
+#include "CmaEs.hpp"
+#include "Dataset.hpp"
+#include "EvolutionStrategy.hpp"
 #include "GeneticAlgorithm.hpp"
+#include "Island.hpp"
+#include "League.hpp"
+#include "Stats.hpp"
+#include "Trace.hpp"
 
-int main() {
-  BlockerFactory f;
+static void LogBlocker(RunnerBlocker::Config const& best, std::string const& tag) {
+  std::ofstream file("./logs/blocker_" + tag + "_" + std::to_string(std::time(0)));
+  double const* p = reinterpret_cast<double const*>(&best);
+
+  for (unsigned int i = 0; i < BlockerFactory::kConfigCount; ++i) {
+    file << p[i] << " ";
+  }
+  file.close();
+}
+
+/* Process-wide reports, at each log interval: the trainer runs until killed, so the
+ * instrumentation's at-exit reports would never be seen. */
+static void LogReports() {
+  GameController::latency_report().Print(std::cerr);
+  STATS_PRINT(std::cerr);
+  PERF_PRINT(std::cerr);
+}
+
+static int RunCmaEs(BlockerFactory& f) {
+  CmaEs<RunnerBlocker::Config> cma(f, RunnerBlocker::Config(), BlockerFactory::LowerBound(),
+                                   BlockerFactory::UpperBound());
+  for (unsigned int g = 0; true; ++g) {
+    RunnerBlocker::Config best = cma.Generation(g);
+    if (g % 10 == 0) {
+      LogReports();
+      LogBlocker(best, "cmaes_" + std::to_string(g));
+    }
+  }
+  return 0;
+}
+
+static int RunLeague(BlockerFactory& f) {
   GeneticAlgorithm<RunnerBlocker::Config> ga(f, 80);
-  std::srand(std::time(0));
+  League<RunnerBlocker::Config> league(f, f, League<RunnerBlocker::Config>::Config());
+  ga.SetLeague(&league);
   for (unsigned int g = 0; true; ++g) {
     RunnerBlocker::Config best = ga.Generation(g);
     if (g % 10 == 0) {
-      std::ofstream file("./logs/blocker_" + std::to_string(g) + "_" +
+      LogReports();
+      LogBlocker(best, "league_" + std::to_string(g));
+    }
+  }
+  return 0;
+}
+
+/* Trains a runner network from random weights; stops after generations if that is not 0. */
+static int RunEvolutionStrategy(unsigned int generations) {
+  NeuralNetworkFactory factory;
+  NeuralNetwork initial = factory.GenerateRandomSpecies();
+  EvolutionStrategy::Config config;
+  if (!EvolutionStrategy::NoiseFits(config, initial)) {
+    std::cerr << "es: the noise table is smaller than the network's "
+              << NeuralNetworkFactory::Flatten(initial).size() << " weights" << std::endl;
+    return 1;
+  }
+  EvolutionStrategy es(factory, initial, config);
+  for (unsigned int g = 0; generations == 0 || g < generations; ++g) {
+    NeuralNetwork network = es.Generation(g);
+    if (g % 10 == 0 || g + 1 == generations) {
+      LogReports();
+      std::ofstream file("./logs/runner_es_" + std::to_string(g) + "_" +
                          std::to_string(std::time(0)));
-      double const* p = reinterpret_cast<double const*>(&best);
+      file << network.Save();
+    }
+  }
+  return 0;
+}
+
+/* Records every decision of RunnerBlocker and advanced_runner playing each other. */
+static int RunDataset(std::string const& path, unsigned int games) {
+  DatasetWriter writer;
+  if (!writer.Open(path)) {
+    std::cerr << "cannot write " << path << std::endl;
+    return 1;
+  }
+
+  NeuralNetwork network(advanced_runner);
+  DualAdvancedRunner runner(network);
+  RunnerBlocker blocker((RunnerBlocker::Config()));
+  DatasetRecorder c1(runner, writer, 0);
+  DatasetRecorder c2(blocker, writer, 1);
+  GameController game;
+  game.AddPlayer(c1);
+  game.AddPlayer(c2);
+  for (unsigned int i = 0; i < games; ++i) {
+    game.Reset();
+    game.RunGame();
+  }
 
-      for (unsigned int i = 0; i < BlockerFactory::kConfigCount; ++i) {
-        file << p[i] << " ";
-      }
-      file.close();
+  writer.Close();
+  std::cout << writer.records() << " decisions from " << games << " games" << std::endl;
+  return 0;
+}
+
+// usage: podracing.exe cmaes
+//        podracing.exe league
+//        podracing.exe es [generations]
+//        podracing.exe dataset file.bin [games]
+//        podracing.exe [--screen fraction] [island_id island_count [directory]]
+// --screen screens every candidate with cheap games and fully evaluates only that fraction.
+int main(int argc, char** argv) {
+  TRACE_THREAD_NAME("main");
+  double screen_fraction = 1.0;
+  std::vector<std::string> args;
+  for (int i = 1; i < argc; ++i) {
+    if (std::string(argv[i]) == "--screen" && i + 1 < argc) {
+      screen_fraction = std::stod(argv[++i]);
+    } else {
+      args.push_back(argv[i]);
+    }
+  }
+
+  BlockerFactory f;
+  if (args.size() >= 1 && args[0] == "cmaes") {
+    std::srand(std::time(0));
+    return RunCmaEs(f);
+  }
+  if (args.size() >= 1 && args[0] == "league") {
+    std::srand(std::time(0));
+    return RunLeague(f);
+  }
+  if (args.size() >= 1 && args[0] == "es") {
+    std::srand(std::time(0));
+    return RunEvolutionStrategy(args.size() >= 2 ? std::stoul(args[1]) : 0);
+  }
+  if (args.size() >= 2 && args[0] == "dataset") {
+    std::srand(std::time(0));
+    return RunDataset(args[1], args.size() >= 3 ? std::stoul(args[2]) : 1000);
+  }
+
+  unsigned int island_id = 0;
+  MigrationCoordinator::Config islands;
+  if (args.size() >= 2) {
+    island_id = std::stoul(args[0]);
+    islands.island_count = std::stoul(args[1]);
+  }
+  if (args.size() >= 3) {
+    islands.directory = args[2];
+  }
+  if (islands.island_count == 0 || island_id >= islands.island_count) {
+    std::cerr << "usage: podracing.exe [--screen fraction] [island_id island_count [directory]]"
+              << std::endl
+              << "island_id must be below island_count" << std::endl;
+    return 1;
+  }
+  MigrationCoordinator coordinator(islands);
+
+  GeneticAlgorithm<RunnerBlocker::Config> ga(f, 80);
+  if (screen_fraction < 1.0) {
+    ga.SetScreening(screen_fraction);
+  }
+  /* A lone GA needs no shared directory and keeps the plain log names. */
+  std::unique_ptr<Island<RunnerBlocker::Config>> island;
+  std::string tag;
+  if (islands.island_count > 1) {
+    island = std::make_unique<Island<RunnerBlocker::Config>>(ga, f, coordinator, island_id);
+    tag = std::to_string(island_id) + "_";
+  }
+  std::srand(std::time(0) + island_id);
+  for (unsigned int g = 0; true; ++g) {
+    RunnerBlocker::Config best = ga.Generation(g);
+    if (island) {
+      island->Migrate(g);
+    }
+    if (g % 10 == 0) {
+      LogReports();
+      LogBlocker(best, tag + std::to_string(g));
     }
   }
   return 0;
-}
\ No newline at end of file
+}
@@ -1,10 +1,12 @@
 #include "NeuralNetwork.hpp"
 #include <limits>
 #include <sstream>
+#include "PerfCounters.hpp"
 
 void NeuralNetwork::AddLayer(Layer const& layer) { layers_.push_back(layer); }
 
 void NeuralNetwork::SetInput(Activations const& input) {
+  PERF_REGION(kRegionSetInput);
   output_ = input;
   for (auto const& layer : layers_) {
     output_ = ApplyLayer(layer, output_);
@@ -44,14 +46,20 @@ std::string NeuralNetwork::Save() const {
 
   return save.str();
 }
-void NeuralNetwork::Load(std::string const& str) {
+bool NeuralNetwork::Load(std::string const& str) {
   std::istringstream load(str);
-  int n_layers;
-  load >> n_layers;
+  int n_layers = 0;
+  if (!(load >> n_layers) || n_layers < 0) {
+    layers_.clear();
+    return false;
+  }
   layers_ = std::vector<Layer>(n_layers);
   for (auto& layer : layers_) {
-    int x, y;
-    load >> x >> y;
+    int x = 0, y = 0;
+    if (!(load >> x >> y) || x < 0 || y < 0) {
+      layers_.clear();
+      return false;
+    }
     layer.bias = Bias(x);
     layer.weight = Weights(x);
     for (auto& b : layer.bias) {
@@ -64,4 +72,5 @@ void NeuralNetwork::Load(std::string const& str) {
       }
     }
   }
+  return !load.fail();
 }
\ No newline at end of file
@@ -25,9 +25,10 @@ class NeuralNetwork {
   void SetInput(Activations const& input);
   Activations const& GetOutput() const { return output_; }
   std::string Save() const;
+  /* Replaces the network with one Save described. False if str is not such a description. */
+  bool Load(std::string const& str);
 
  private:
-  void Load(std::string const& str);
 
   Activations ApplyLayer(Layer const& layer, Activations const& input);
 